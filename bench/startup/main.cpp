@@ -0,0 +1,94 @@
+// Time spent before main registering TYPE_COUNT types, eagerly and lazily.  Static initialization runs in definition
+// order within this file, so the clocks between the registrations time each of them.
+
+#include <yadi/yadi.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+template <bool LAZY>
+struct startup_widget {
+    std::string name;
+    int count;
+    std::vector<std::string> tags;
+};
+
+template <bool LAZY>
+struct factory_traits<startup_widget<LAZY>> {
+    using ptr_type = startup_widget<LAZY>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+using startup_clock = std::chrono::steady_clock;
+
+constexpr int TYPE_COUNT = 1000;
+
+template <bool LAZY>
+startup_widget<LAZY> make_startup_widget(std::string name, int count, std::vector<std::string> tags) {
+    return startup_widget<LAZY>{std::move(name), count, std::move(tags)};
+}
+
+template <bool LAZY>
+yadi_info_t<startup_widget<LAZY>> startup_widget_info() {
+    return make_map_initializer_with_help<startup_widget<LAZY>>(
+        &make_startup_widget<LAZY>, {std::make_pair("name"s, "Widget name"s), std::make_pair("count"s, "How many"s),
+                                     std::make_pair("tags"s, "Labels"s)});
+}
+
+std::string type_name(int index) { return "widget_" + std::to_string(index); }
+
+startup_clock::time_point const START = startup_clock::now();
+
+YADI_INIT_BEGIN_N(eager)
+for (int i = 0; i < TYPE_COUNT; ++i) {
+    ::yadi::register_type<startup_widget<false>>(type_name(i), startup_widget_info<false>());
+}
+YADI_INIT_END_N(eager)
+
+startup_clock::time_point const EAGER_END = startup_clock::now();
+
+YADI_INIT_BEGIN_N(lazy)
+for (int i = 0; i < TYPE_COUNT; ++i) {
+    ::yadi::register_type_lazy<startup_widget<true>>(type_name(i), &startup_widget_info<true>);
+}
+YADI_INIT_END_N(lazy)
+
+startup_clock::time_point const LAZY_END = startup_clock::now();
+
+void report(std::string const& name, startup_clock::duration elapsed) {
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed
+              << std::setprecision(1) << std::chrono::duration<double, std::micro>(elapsed).count() << " us"
+              << std::endl;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
+
+int main() {
+    using namespace yadi;
+
+    report("startup/eager/" + std::to_string(TYPE_COUNT), EAGER_END - START);
+    report("startup/lazy/" + std::to_string(TYPE_COUNT), LAZY_END - EAGER_END);
+
+    // What the lazy registrations cost when a type is first used
+    YAML::Node const config = YAML::Load("{name: a, count: 1, tags: [x]}");
+    startup_clock::time_point const first_use = startup_clock::now();
+    for (int i = 0; i < TYPE_COUNT; ++i) {
+        factory<startup_widget<true>>::create(type_name(i), config);
+    }
+    report("startup/lazy_first_create/" + std::to_string(TYPE_COUNT), startup_clock::now() - first_use);
+    startup_clock::time_point const second_use = startup_clock::now();
+    for (int i = 0; i < TYPE_COUNT; ++i) {
+        factory<startup_widget<true>>::create(type_name(i), config);
+    }
+    report("startup/lazy_later_create/" + std::to_string(TYPE_COUNT), startup_clock::now() - second_use);
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "bench.hpp"
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace yadi {
+
+namespace {
+
+// Built as text, inserting into a YAML::Node map searches it linearly
+YAML::Node int_sequence(std::size_t size) {
+    std::string text;
+    for (std::size_t i = 0; i < size; ++i) {
+        text += "- " + std::to_string(i) + "\n";
+    }
+    return YAML::Load(text);
+}
+
+YAML::Node int_map(std::size_t size) {
+    std::string text;
+    for (std::size_t i = 0; i < size; ++i) {
+        text += "key_" + std::to_string(i) + ": " + std::to_string(i) + "\n";
+    }
+    return YAML::Load(text);
+}
+
+template <typename CT, typename = void>
+struct is_map : std::false_type {};
+
+template <typename CT>
+struct is_map<CT, std::void_t<typename CT::mapped_type>> : std::true_type {};
+
+// Time is reported per element
+template <typename CT, std::size_t SIZE>
+void adapter_create(bench::state& state) {
+    YAML::Node const config = is_map<CT>::value ? int_map(SIZE) : int_sequence(SIZE);
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<CT>(config));
+    }
+}
+
+template <std::size_t SIZE>
+void register_adapter_benches() {
+    std::string const size = std::to_string(SIZE);
+    bench::register_bench("adapter/vector/" + size, &adapter_create<std::vector<int>, SIZE>);
+    bench::register_bench("adapter/vector_double/" + size, &adapter_create<std::vector<double>, SIZE>);
+    bench::register_bench("adapter/deque/" + size, &adapter_create<std::deque<int>, SIZE>);
+    bench::register_bench("adapter/set/" + size, &adapter_create<std::set<int>, SIZE>);
+    bench::register_bench("adapter/flat_set/" + size, &adapter_create<flat_set<int>, SIZE>);
+    bench::register_bench("adapter/map/" + size, &adapter_create<std::map<std::string, int>, SIZE>);
+    bench::register_bench("adapter/unordered_map/" + size, &adapter_create<std::unordered_map<std::string, int>, SIZE>);
+    bench::register_bench("adapter/flat_map/" + size, &adapter_create<flat_map<std::string, int>, SIZE>);
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+register_adapter_benches<16>();
+register_adapter_benches<1024>();
+register_adapter_benches<100000>();
+register_adapter_benches<1000000>();
+YADI_INIT_END
+
+}  // namespace yadi
@@ -0,0 +1,91 @@
+#include "bench.hpp"
+
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+// A small short lived strategy, created and destroyed per use
+struct alloc_bench_strategy {
+    virtual ~alloc_bench_strategy() = default;
+    virtual int apply(int value) const = 0;
+};
+
+template <typename PT, typename AP>
+struct alloc_bench_base : public alloc_bench_strategy {};
+
+template <typename PT, typename AP>
+struct factory_traits<alloc_bench_base<PT, AP>> {
+    using ptr_type = PT;
+    static constexpr bool direct_from_yaml = false;
+    using allocation = AP;
+};
+
+namespace {
+
+template <typename PT, typename AP>
+struct alloc_bench_offset : public alloc_bench_base<PT, AP> {
+    explicit alloc_bench_offset(int offset) : offset(offset) {}
+    int apply(int value) const override { return value + offset; }
+    int offset;
+};
+
+// Creates BATCH strategies then destroys them, time is reported per strategy
+template <typename PT, typename AP, std::size_t BATCH>
+void create_strategies(bench::state& state) {
+    using base_type = alloc_bench_base<PT, AP>;
+    std::vector<ptr_type_t<base_type>> strategies;
+    strategies.reserve(BATCH);
+    state.set_items_processed(state.iterations() * BATCH);
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            strategies.push_back(ctr<base_type, alloc_bench_offset<PT, AP>>(static_cast<int>(i)));
+        }
+        bench::do_not_optimize(strategies.back()->apply(1));
+        strategies.clear();
+    }
+}
+
+// A request's strategies come from its arena, which is released in bulk afterwards
+template <typename PT, std::size_t BATCH>
+void create_strategies_arena(bench::state& state) {
+    using base_type = alloc_bench_base<PT, arena_allocation>;
+    arena request;
+    std::vector<ptr_type_t<base_type>> strategies;
+    strategies.reserve(BATCH);
+    state.set_items_processed(state.iterations() * BATCH);
+    while (state.keep_running()) {
+        {
+            arena_scope scope(request);
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                strategies.push_back(ctr<base_type, alloc_bench_offset<PT, arena_allocation>>(static_cast<int>(i)));
+            }
+        }
+        bench::do_not_optimize(strategies.back()->apply(1));
+        strategies.clear();
+        request.release();
+    }
+}
+
+template <std::size_t BATCH>
+void register_allocation_benches() {
+    using unique_type = std::unique_ptr<alloc_bench_strategy>;
+    using pooled_type = pooled_ptr<alloc_bench_strategy>;
+    using shared_type = std::shared_ptr<alloc_bench_strategy>;
+    std::string const batch = std::to_string(BATCH);
+    bench::register_bench("allocation/unique/new/" + batch, &create_strategies<unique_type, new_allocation, BATCH>);
+    bench::register_bench("allocation/unique/pool/" + batch, &create_strategies<pooled_type, pool_allocation, BATCH>);
+    bench::register_bench("allocation/unique/arena/" + batch, &create_strategies_arena<pooled_type, BATCH>);
+    bench::register_bench("allocation/shared/new/" + batch, &create_strategies<shared_type, new_allocation, BATCH>);
+    bench::register_bench("allocation/shared/pool/" + batch, &create_strategies<shared_type, pool_allocation, BATCH>);
+    bench::register_bench("allocation/shared/arena/" + batch, &create_strategies_arena<shared_type, BATCH>);
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+register_allocation_benches<1>();
+register_allocation_benches<1000>();
+YADI_INIT_END
+
+}  // namespace yadi
@@ -0,0 +1,70 @@
+#include "bench.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+// Stands in for a handler that precomputes a table when constructed
+struct table_handler {
+    std::vector<double> table;
+};
+
+template <>
+struct factory_traits<table_handler> {
+    using ptr_type = std::unique_ptr<table_handler>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+constexpr std::size_t BATCH_SIZE = 256;
+
+YAML::Node handler_configs() {
+    YAML::Node configs;
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+        YAML::Node config;
+        config["type"] = "table_handler";
+        config["config"]["size"] = 20000;
+        configs.push_back(config);
+    }
+    return configs;
+}
+
+// Time is reported per handler
+template <std::size_t THREADS>
+void create_batch_threads(bench::state& state) {
+    YAML::Node const configs = handler_configs();
+    state.set_items_processed(state.iterations() * BATCH_SIZE);
+    while (state.keep_running()) {
+        std::vector<std::unique_ptr<table_handler>> handlers;
+        if (THREADS == 0) {
+            from_yamls<std::unique_ptr<table_handler>>(configs, std::back_inserter(handlers));
+        } else {
+            from_yamls_parallel<std::unique_ptr<table_handler>>(configs, std::back_inserter(handlers), THREADS);
+        }
+        bench::do_not_optimize(handlers);
+    }
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+register_type<table_handler>("table_handler", [](YAML::Node const& config) {
+    std::unique_ptr<table_handler> handler(new table_handler());
+    std::size_t const size = config["size"].as<std::size_t>();
+    handler->table.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        handler->table.push_back(std::sin(static_cast<double>(i)) * std::sqrt(static_cast<double>(i)));
+    }
+    return handler;
+});
+bench::register_bench("create_batch/serial", &create_batch_threads<0>);
+bench::register_bench("create_batch/threads/1", &create_batch_threads<1>);
+bench::register_bench("create_batch/threads/2", &create_batch_threads<2>);
+bench::register_bench("create_batch/threads/4", &create_batch_threads<4>);
+bench::register_bench("create_batch/threads/8", &create_batch_threads<8>);
+YADI_INIT_END
+
+}  // namespace yadi
@@ -0,0 +1,106 @@
+#ifndef YADI_BENCH_HPP
+#define YADI_BENCH_HPP
+
+#include <yadi/yadi.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace yadi {
+namespace bench {
+
+/**
+ * @brief Timing loop handed to a benchmark.  The benchmark runs its body while keep_running() returns true and the
+ * elapsed time between the first and last call is reported per iteration.
+ */
+class state {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    explicit state(std::size_t iterations)
+        : iteration_count(iterations), items(iterations), remaining(iterations), paused(0) {}
+
+    bool keep_running() {
+        if (this->remaining == this->iteration_count) {
+            this->start = clock::now();
+        }
+        if (this->remaining == 0) {
+            this->stop = clock::now();
+            return false;
+        }
+        --this->remaining;
+        return true;
+    }
+
+    /**
+     * @brief Alternative to keep_running() for benchmarks driving their own loop, for example across threads.  Times
+     * a single call to run, which should perform iterations() iterations.
+     */
+    template <typename F>
+    void measure(F&& run) {
+        this->start = clock::now();
+        run();
+        this->stop = clock::now();
+        this->remaining = 0;
+    }
+
+    /**
+     * @brief Reports time per item instead of per iteration.  Defaults to iterations().
+     */
+    void set_items_processed(std::size_t items_processed) { this->items = items_processed; }
+
+    /**
+     * @brief Excludes the time until resume_timing() is called, for per iteration setup.
+     */
+    void pause_timing() { this->pause_start = clock::now(); }
+
+    void resume_timing() { this->paused += clock::now() - this->pause_start; }
+
+    std::size_t iterations() const { return this->iteration_count; }
+
+    std::size_t items_processed() const { return this->items; }
+
+    clock::duration elapsed() const { return this->stop - this->start - this->paused; }
+
+   private:
+    std::size_t iteration_count;
+    std::size_t items;
+    std::size_t remaining;
+    clock::time_point start;
+    clock::time_point stop;
+    clock::time_point pause_start;
+    clock::duration paused;
+};
+
+using function = std::function<void(state&)>;
+
+inline std::map<std::string, function>& registry() {
+    static std::map<std::string, function> BENCHES;
+    return BENCHES;
+}
+
+inline void register_bench(std::string name, function bench) { registry()[std::move(name)] = std::move(bench); }
+
+/**
+ * @brief Keeps the compiler from optimizing away value.
+ */
+template <typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace bench
+}  // namespace yadi
+
+#define YADI_BENCH(NAME) YADI_BENCH_(NAME)
+#define YADI_BENCH_(NAME)                               \
+    void NAME(::yadi::bench::state& state);             \
+    YADI_INIT_BEGIN_N(NAME)                             \
+    ::yadi::bench::register_bench(#NAME, &NAME);        \
+    YADI_INIT_END_N(NAME)                               \
+    void NAME(::yadi::bench::state& state)
+
+#endif  // YADI_BENCH_HPP
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+struct cached_bench_type {};
+
+template <>
+struct factory_traits<cached_bench_type> {
+    using ptr_type = std::shared_ptr<cached_bench_type>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+// Nested maps width wide and depth deep, with a short list at each leaf
+YAML::Node build_nested_config(std::size_t width, std::size_t depth) {
+    YAML::Node config;
+    for (std::size_t i = 0; i < width; ++i) {
+        std::string const key = "field_" + std::to_string(i);
+        if (depth > 1) {
+            config[key] = build_nested_config(width, depth - 1);
+        } else {
+            config[key].push_back(i);
+            config[key].push_back("value_" + std::to_string(i));
+        }
+    }
+    return config;
+}
+
+// Round tripped so the nodes are laid out like a loaded config file
+YAML::Node make_nested_config(std::size_t width, std::size_t depth) {
+    return YAML::Load(YAML::Dump(build_nested_config(width, depth)));
+}
+
+// The key the caching initializer used before structural hashing
+template <std::size_t WIDTH, std::size_t DEPTH>
+void caching_hit_dump_key(bench::state& state) {
+    YAML::Node const config = make_nested_config(WIDTH, DEPTH);
+    std::shared_ptr<cached_bench_type> instance = std::make_shared<cached_bench_type>();
+    std::map<std::string, std::weak_ptr<cached_bench_type>> cache;
+    cache[YAML::Dump(config)] = instance;
+
+    while (state.keep_running()) {
+        bench::do_not_optimize(cache.find(YAML::Dump(config))->second.lock());
+    }
+}
+
+template <std::size_t WIDTH, std::size_t DEPTH>
+void caching_hit_structural_key(bench::state& state) {
+    YAML::Node const config = make_nested_config(WIDTH, DEPTH);
+    auto initializer = make_caching_initializer<cached_bench_type>(
+        [](YAML::Node const&) { return std::make_shared<cached_bench_type>(); });
+    std::shared_ptr<cached_bench_type> instance = initializer(config);
+
+    while (state.keep_running()) {
+        bench::do_not_optimize(initializer(config));
+    }
+}
+
+// No instance is held between calls, so each lookup finds an expired entry and creates a new instance
+template <std::size_t WIDTH, std::size_t DEPTH>
+void caching_miss(bench::state& state) {
+    std::vector<YAML::Node> configs;
+    for (int i = 0; i < 64; ++i) {
+        YAML::Node config = make_nested_config(WIDTH, DEPTH);
+        config["id"] = i;
+        configs.push_back(config);
+    }
+    auto initializer = make_caching_initializer<cached_bench_type>(
+        [](YAML::Node const&) { return std::make_shared<cached_bench_type>(); });
+
+    std::size_t i = 0;
+    while (state.keep_running()) {
+        bench::do_not_optimize(initializer(configs[i]));
+        i = (i + 1 == configs.size()) ? 0 : i + 1;
+    }
+}
+
+template <std::size_t WIDTH, std::size_t DEPTH>
+void register_caching_hit_benches() {
+    std::string const size = std::to_string(WIDTH) + "x" + std::to_string(DEPTH);
+    bench::register_bench("caching_hit/dump_key/" + size, &caching_hit_dump_key<WIDTH, DEPTH>);
+    bench::register_bench("caching_hit/structural_key/" + size, &caching_hit_structural_key<WIDTH, DEPTH>);
+    bench::register_bench("caching_miss/" + size, &caching_miss<WIDTH, DEPTH>);
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+register_caching_hit_benches<4, 2>();
+register_caching_hit_benches<8, 3>();
+register_caching_hit_benches<16, 3>();
+YADI_INIT_END
+
+}  // namespace yadi
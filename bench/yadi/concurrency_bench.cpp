@@ -0,0 +1,67 @@
+#include "bench.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace yadi {
+
+struct throughput_type {
+    std::size_t index;
+};
+
+template <>
+struct factory_traits<throughput_type> {
+    using ptr_type = throughput_type;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+constexpr std::size_t THROUGHPUT_TYPE_COUNT = 100;
+
+std::vector<std::string> throughput_names() {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < THROUGHPUT_TYPE_COUNT; ++i) {
+        names.push_back("throughput_type_" + std::to_string(i));
+    }
+    return names;
+}
+
+// Each thread performs iterations() creates, the reported time is per create across all threads
+template <std::size_t THREADS>
+void factory_create_threads(bench::state& state) {
+    std::vector<std::string> const names = throughput_names();
+    std::size_t const iterations = state.iterations();
+    state.set_items_processed(iterations * THREADS);
+    state.measure([&names, iterations]() {
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&names, iterations, t]() {
+                std::size_t i = t;
+                for (std::size_t n = 0; n < iterations; ++n) {
+                    bench::do_not_optimize(factory<throughput_type>::create(names[i % names.size()]));
+                    ++i;
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    });
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+std::vector<std::string> const names = throughput_names();
+for (std::size_t i = 0; i < names.size(); ++i) {
+    register_type<throughput_type>(names[i], [i](YAML::Node const&) { return throughput_type{i}; });
+}
+bench::register_bench("factory_create_threads/1", &factory_create_threads<1>);
+bench::register_bench("factory_create_threads/2", &factory_create_threads<2>);
+bench::register_bench("factory_create_threads/4", &factory_create_threads<4>);
+bench::register_bench("factory_create_threads/8", &factory_create_threads<8>);
+YADI_INIT_END
+
+}  // namespace yadi
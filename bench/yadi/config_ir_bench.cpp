@@ -0,0 +1,126 @@
+#include "bench.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+struct ir_bench_widget {
+    ir_bench_widget(std::string name, int count, double weight, bool enabled)
+        : name(std::move(name)), count(count), weight(weight), enabled(enabled) {}
+
+    std::string name;
+    int count;
+    double weight;
+    bool enabled;
+};
+
+template <>
+struct factory_traits<ir_bench_widget> {
+    using ptr_type = std::shared_ptr<ir_bench_widget>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+ptr_type_t<ir_bench_widget> make_ir_bench_widget(std::string name, int count, double weight, bool enabled) {
+    return std::make_shared<ir_bench_widget>(std::move(name), count, weight, enabled);
+}
+
+// A sequence of SIZE widget factory configs, round tripped so the nodes are laid out like a loaded config file
+YAML::Node widget_configs(std::size_t size) {
+    YAML::Node configs;
+    for (std::size_t i = 0; i < size; ++i) {
+        YAML::Node config;
+        config["type"] = "ir_widget";
+        config["config"]["name"] = "widget_" + std::to_string(i);
+        config["config"]["count"] = i;
+        config["config"]["weight"] = i * 0.5;
+        config["config"]["enabled"] = (i % 2) == 0;
+        configs.push_back(config);
+    }
+    return YAML::Load(YAML::Dump(configs));
+}
+
+// Time is reported per element
+template <std::size_t SIZE>
+void from_yaml_yaml(bench::state& state) {
+    YAML::Node const configs = widget_configs(SIZE);
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<std::vector<ptr_type_t<ir_bench_widget>>>(configs));
+    }
+}
+
+template <std::size_t SIZE>
+void from_yaml_config_ir(bench::state& state) {
+    config_document const document(widget_configs(SIZE));
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<std::vector<ptr_type_t<ir_bench_widget>>>(document.root()));
+    }
+}
+
+// The one time cost of building the document
+template <std::size_t SIZE>
+void config_ir_build(bench::state& state) {
+    YAML::Node const configs = widget_configs(SIZE);
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        bench::do_not_optimize(config_document(configs).size());
+    }
+}
+
+// Startup from a config file, reading it as YAML or mapping it compiled
+template <std::size_t SIZE>
+void config_load_yaml(bench::state& state) {
+    std::string const path = "config_load_" + std::to_string(SIZE) + ".yaml";
+    {
+        std::ofstream out(path);
+        out << widget_configs(SIZE);
+    }
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<std::vector<ptr_type_t<ir_bench_widget>>>(YAML::LoadFile(path)));
+    }
+    std::remove(path.c_str());
+}
+
+template <std::size_t SIZE>
+void config_load_mapped(bench::state& state) {
+    std::string const path = "config_load_" + std::to_string(SIZE) + ".yadicfg";
+    {
+        std::ofstream out(path, std::ios::binary);
+        config_document(widget_configs(SIZE)).save(out);
+    }
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        config_document const document = config_document::map_file(path);
+        bench::do_not_optimize(from_yaml<std::vector<ptr_type_t<ir_bench_widget>>>(document.root()));
+    }
+    std::remove(path.c_str());
+}
+
+template <std::size_t SIZE>
+void register_config_ir_benches() {
+    std::string const size = std::to_string(SIZE);
+    bench::register_bench("from_yaml/widgets/yaml/" + size, &from_yaml_yaml<SIZE>);
+    bench::register_bench("from_yaml/widgets/config_ir/" + size, &from_yaml_config_ir<SIZE>);
+    bench::register_bench("config_ir/build/" + size, &config_ir_build<SIZE>);
+    bench::register_bench("config_load/yaml/" + size, &config_load_yaml<SIZE>);
+    bench::register_bench("config_load/mapped/" + size, &config_load_mapped<SIZE>);
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+std::vector<std::string> const fields{"name", "count", "weight", "enabled"};
+::yadi::register_type<ir_bench_widget>(
+    "ir_widget", make_map_initializer_with_help<ir_bench_widget>(&make_ir_bench_widget, fields));
+register_config_ir_benches<100>();
+register_config_ir_benches<10000>();
+YADI_INIT_END
+
+}  // namespace yadi
@@ -0,0 +1,191 @@
+#include "bench.hpp"
+
+#include <string>
+#include <utility>
+
+namespace yadi {
+
+struct bench_widget {
+    int value;
+};
+
+template <>
+struct factory_traits<bench_widget> {
+    using ptr_type = bench_widget;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+template <std::size_t>
+using field_type = int;
+
+// A function taking one int per field
+template <std::size_t... I>
+struct field_sum {
+    static int sum(field_type<I>... fields) { return (0 + ... + fields); }
+};
+
+template <std::size_t... I>
+auto make_field_sum(std::index_sequence<I...>) {
+    return &field_sum<I...>::sum;
+}
+
+std::vector<std::string> field_names(std::size_t count) {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back("field_" + std::to_string(i));
+    }
+    return names;
+}
+
+YAML::Node field_config(std::size_t count) {
+    YAML::Node config;
+    for (std::size_t i = 0; i < count; ++i) {
+        config["field_" + std::to_string(i)] = i;
+    }
+    return YAML::Load(YAML::Dump(config));
+}
+
+YAML::Node value_config(int value) {
+    YAML::Node config;
+    config["value"] = value;
+    return config;
+}
+
+template <std::size_t FIELDS>
+void map_initializer(bench::state& state) {
+    auto initializer = make_map_initializer<int>(make_field_sum(std::make_index_sequence<FIELDS>()),
+                                                 field_names(FIELDS));
+    YAML::Node const config = field_config(FIELDS);
+    while (state.keep_running()) {
+        bench::do_not_optimize(initializer(config));
+    }
+}
+
+template <std::size_t DEPTH>
+void alias_chain(bench::state& state) {
+    std::string const alias = "bench_widget_alias_" + std::to_string(DEPTH);
+    while (state.keep_running()) {
+        bench::do_not_optimize(factory<bench_widget>::create(alias));
+    }
+}
+
+// Each alias in the chain adds a field to the config it passes on
+template <std::size_t DEPTH>
+void register_alias_chain() {
+    std::string type = "bench_widget";
+    for (std::size_t depth = 1; depth <= DEPTH; ++depth) {
+        std::string alias = "bench_widget_alias_" + std::to_string(depth);
+        YAML::Node config;
+        config["level_" + std::to_string(depth)] = depth;
+        register_alias<bench_widget>(alias, type, config);
+        type = std::move(alias);
+    }
+    bench::register_bench("alias_chain/" + std::to_string(DEPTH), &alias_chain<DEPTH>);
+}
+
+template <std::size_t FIELDS>
+void merge_yaml_fields(bench::state& state) {
+    YAML::Node const left = field_config(FIELDS);
+    YAML::Node const right = YAML::Load("{value: 1}");
+    while (state.keep_running()) {
+        bench::do_not_optimize(merge_yaml(left, right));
+    }
+}
+
+// Alias defaults carrying a large table which the passed config replaces
+template <merge_mode MODE>
+void merge_yaml_table(bench::state& state) {
+    YAML::Node left;
+    left["table"] = field_config(1000);
+    left["value"] = 1;
+    YAML::Node const right = YAML::Load("{table: {field_1: 5}}");
+    while (state.keep_running()) {
+        bench::do_not_optimize(merge_yaml(left, right, MODE));
+    }
+}
+
+}  // anonymous namespace
+
+YADI_BENCH(factory_create_config) {
+    YAML::Node const config = value_config(3);
+    while (state.keep_running()) {
+        bench::do_not_optimize(factory<bench_widget>::create("bench_widget", config));
+    }
+}
+
+YADI_BENCH(from_yaml_scalar_type) {
+    YAML::Node const config = YAML::Load("bench_widget");
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<bench_widget>(config));
+    }
+}
+
+YADI_BENCH(from_yaml_scalar_value) {
+    YAML::Node const config = YAML::Load("12345");
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<int>(config));
+    }
+}
+
+YADI_BENCH(from_yaml_scalar_double) {
+    YAML::Node const config = YAML::Load("1234.5678");
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<double>(config));
+    }
+}
+
+YADI_BENCH(from_yaml_scalar_bool) {
+    YAML::Node const config = YAML::Load("true");
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<bool>(config));
+    }
+}
+
+YADI_BENCH(from_yaml_scalar_string) {
+    YAML::Node const config = YAML::Load("a short string");
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<std::string>(config));
+    }
+}
+
+YADI_BENCH(from_yaml_scalar_config_node) {
+    config_document const document = config_document::load("12345");
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<int>(document.root()));
+    }
+}
+
+YADI_BENCH(from_yaml_map) {
+    YAML::Node const config = YAML::Load("{type: bench_widget, config: {value: 3}}");
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<bench_widget>(config));
+    }
+}
+
+YADI_BENCH(sequence_initializer) {
+    auto initializer = make_sequence_initializer<int>(make_field_sum(std::make_index_sequence<4>()));
+    YAML::Node const config = YAML::Load("[1, 2, 3, 4]");
+    while (state.keep_running()) {
+        bench::do_not_optimize(initializer(config));
+    }
+}
+
+YADI_INIT_BEGIN
+register_type<bench_widget>("bench_widget", [](YAML::Node const& config) {
+    return bench_widget{config["value"].as<int>(0)};
+});
+bench::register_bench("map_initializer/2", &map_initializer<2>);
+bench::register_bench("map_initializer/8", &map_initializer<8>);
+bench::register_bench("map_initializer/32", &map_initializer<32>);
+register_alias_chain<1>();
+register_alias_chain<4>();
+register_alias_chain<8>();
+bench::register_bench("merge_yaml/2", &merge_yaml_fields<2>);
+bench::register_bench("merge_yaml/32", &merge_yaml_fields<32>);
+bench::register_bench("merge_yaml/table/shallow", &merge_yaml_table<merge_mode::shallow>);
+bench::register_bench("merge_yaml/table/deep", &merge_yaml_table<merge_mode::deep>);
+YADI_INIT_END
+
+}  // namespace yadi
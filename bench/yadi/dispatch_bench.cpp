@@ -0,0 +1,58 @@
+#include "bench.hpp"
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+// The initializer types before and after, called the way factory<BT>::create calls them
+using std_initializer = std::function<std::size_t(YAML::Node)>;
+using inline_initializer = details::inline_function<std::size_t(YAML::Node const&)>;
+
+// Captures the size of make_map_initializer's and register_alias's, both past std::function's small buffer
+auto fields_initializer() {
+    std::vector<std::string> fields{"name", "count", "weight"};
+    auto func = &std::strlen;
+    return [fields, func](YAML::Node const& config) { return fields.size() + func("x") + config.size(); };
+}
+
+auto alias_initializer() {
+    std::string type = "a_type_name_past_small_strings";
+    YAML::Node config = YAML::Load("{a: 1}");
+    return [type, config](YAML::Node const& passed) { return type.size() + config.size() + passed.size(); };
+}
+
+auto empty_initializer() {
+    return [](YAML::Node const& config) { return config.size(); };
+}
+
+template <typename IT, typename F>
+void dispatch(bench::state& state, F make) {
+    IT const initializer = make();
+    YAML::Node const config = YAML::Load("{a: 1, b: 2}");
+    while (state.keep_running()) {
+        bench::do_not_optimize(initializer(config));
+    }
+}
+
+template <typename IT>
+void register_dispatch_benches(std::string const& name) {
+    bench::register_bench("dispatch/" + name + "/empty",
+                          [](bench::state& state) { dispatch<IT>(state, &empty_initializer); });
+    bench::register_bench("dispatch/" + name + "/fields",
+                          [](bench::state& state) { dispatch<IT>(state, &fields_initializer); });
+    bench::register_bench("dispatch/" + name + "/alias",
+                          [](bench::state& state) { dispatch<IT>(state, &alias_initializer); });
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+register_dispatch_benches<std_initializer>("std_function");
+register_dispatch_benches<inline_initializer>("inline_function");
+YADI_INIT_END
+
+}  // namespace yadi
@@ -0,0 +1,155 @@
+#include "bench.hpp"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+template <std::size_t COUNT, bool FROZEN>
+struct lookup_type {
+    std::size_t index;
+};
+
+template <std::size_t COUNT, bool FROZEN>
+struct factory_traits<lookup_type<COUNT, FROZEN>> {
+    using ptr_type = lookup_type<COUNT, FROZEN>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+std::vector<std::string> lookup_names(std::size_t count) {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back("lookup_type_" + std::to_string(i));
+    }
+    return names;
+}
+
+template <std::size_t COUNT, bool FROZEN>
+void register_lookup_types() {
+    using type = lookup_type<COUNT, FROZEN>;
+    std::vector<std::string> const names = lookup_names(COUNT);
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        register_type<type>(names[i], [i](YAML::Node const&) { return type{i}; });
+    }
+}
+
+template <std::size_t COUNT, bool FROZEN>
+void factory_create(bench::state& state) {
+    using type = lookup_type<COUNT, FROZEN>;
+    if (FROZEN) {
+        factory<type>::freeze();
+    }
+
+    // Cycle through every registered name so one hot entry doesn't hide the lookup cost
+    std::vector<std::string> const names = lookup_names(COUNT);
+    std::size_t i = 0;
+    while (state.keep_running()) {
+        bench::do_not_optimize(factory<type>::create(names[i]));
+        i = (i + 1 == names.size()) ? 0 : i + 1;
+    }
+}
+
+// IDs resolved once up front, as a hot loop would cache them
+template <std::size_t COUNT>
+void factory_create_type_id(bench::state& state) {
+    using type = lookup_type<COUNT, false>;
+    std::vector<type_id> ids;
+    for (std::string const& name : lookup_names(COUNT)) {
+        ids.push_back(factory<type>::resolve(name));
+    }
+    std::size_t i = 0;
+    while (state.keep_running()) {
+        bench::do_not_optimize(factory<type>::create(ids[i]));
+        i = (i + 1 == ids.size()) ? 0 : i + 1;
+    }
+}
+
+// Unknown names, as a caller falling back to a default type sees them
+void factory_create_not_found(bench::state& state) {
+    using type = lookup_type<10, false>;
+    while (state.keep_running()) {
+        try {
+            bench::do_not_optimize(factory<type>::create("missing"));
+        } catch (std::runtime_error const& ex) {
+            bench::do_not_optimize(ex.what());
+        }
+    }
+}
+
+void factory_try_create_not_found(bench::state& state) {
+    using type = lookup_type<10, false>;
+    while (state.keep_running()) {
+        bench::do_not_optimize(factory<type>::try_create("missing").has_value());
+    }
+}
+
+// Optional components probed with fallbacks, the config names a type that isn't registered
+void from_yaml_unknown_type(bench::state& state) {
+    using type = lookup_type<10, false>;
+    YAML::Node const config = YAML::Load("{type: missing, config: {level: 1}}");
+    while (state.keep_running()) {
+        try {
+            bench::do_not_optimize(from_yaml<type>(config));
+        } catch (std::runtime_error const& ex) {
+            bench::do_not_optimize(ex.what());
+        }
+    }
+}
+
+void try_from_yaml_unknown_type(bench::state& state) {
+    using type = lookup_type<10, false>;
+    YAML::Node const config = YAML::Load("{type: missing, config: {level: 1}}");
+    while (state.keep_running()) {
+        bench::do_not_optimize(try_from_yaml<type>(config).has_value());
+    }
+}
+
+// The cost of the trace hook, with no sink and recording into a ring
+template <bool TRACED>
+void from_yaml_trace(bench::state& state) {
+    using type = lookup_type<10, false>;
+    YAML::Node const config = YAML::Load("{type: lookup_type_3, config: {level: 1}}");
+    trace_ring_sink sink;
+    set_trace_sink(TRACED ? &sink : nullptr);
+    while (state.keep_running()) {
+        bench::do_not_optimize(from_yaml<type>(config));
+    }
+    set_trace_sink(nullptr);
+}
+
+void adapter_get_name(bench::state& state) {
+    using container = std::map<std::string, std::vector<lookup_type<10, false>>>;
+    while (state.keep_running()) {
+        bench::do_not_optimize(adapter<std::vector<container>>::get_name().size());
+    }
+}
+
+template <std::size_t COUNT>
+void register_factory_create_benches() {
+    register_lookup_types<COUNT, false>();
+    register_lookup_types<COUNT, true>();
+    bench::register_bench("factory_create/unfrozen/" + std::to_string(COUNT), &factory_create<COUNT, false>);
+    bench::register_bench("factory_create/frozen/" + std::to_string(COUNT), &factory_create<COUNT, true>);
+    bench::register_bench("factory_create/type_id/" + std::to_string(COUNT), &factory_create_type_id<COUNT>);
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+register_factory_create_benches<10>();
+register_factory_create_benches<100>();
+register_factory_create_benches<1000>();
+bench::register_bench("factory_create/not_found", &factory_create_not_found);
+bench::register_bench("factory_try_create/not_found", &factory_try_create_not_found);
+bench::register_bench("from_yaml/unknown_type", &from_yaml_unknown_type);
+bench::register_bench("try_from_yaml/unknown_type", &try_from_yaml_unknown_type);
+bench::register_bench("from_yaml/untraced", &from_yaml_trace<false>);
+bench::register_bench("from_yaml/trace_ring", &from_yaml_trace<true>);
+bench::register_bench("adapter_get_name/nested", &adapter_get_name);
+YADI_INIT_END
+
+}  // namespace yadi
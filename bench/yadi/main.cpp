@@ -0,0 +1,99 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct result {
+    std::string name;
+    std::size_t iterations;
+    std::size_t items;
+    double seconds;
+};
+
+void write_json(std::ostream& out, std::vector<result> const& results) {
+    out << "{\n  \"context\": {\n    \"library\": \"yadi\",\n    \"time_unit\": \"ns\"\n  },\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        result const& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\n"
+            << "      \"name\": " << yadi::details::json_string(r.name) << ",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"items\": " << r.items << ",\n"
+            << "      \"real_time\": " << std::setprecision(17) << r.seconds * 1e9 << ",\n"
+            << "      \"ns_per_item\": " << r.seconds * 1e9 / r.items << ",\n"
+            << "      \"items_per_second\": " << (r.seconds > 0 ? r.items / r.seconds : 0.0) << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    using namespace yadi;
+
+    std::string filter;
+    std::string json_path;
+    double min_time = 0.2;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            min_time = std::atof(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter <substring>] [--min-time <seconds>] [--json <file or - for stdout>]\n";
+            return 1;
+        }
+    }
+
+    // With JSON on stdout the table goes to stderr so the output stays parseable
+    std::ostream& table = json_path == "-" ? std::cerr : std::cout;
+    std::vector<result> results;
+    for (auto const& entry : bench::registry()) {
+        std::string const& name = entry.first;
+        if (name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        // Grow the iteration count until the run takes at least min_time
+        std::size_t iterations = 1;
+        std::size_t items = 1;
+        double seconds = 0;
+        while (true) {
+            bench::state state(iterations);
+            entry.second(state);
+            seconds = std::chrono::duration<double>(state.elapsed()).count();
+            items = state.items_processed();
+            if (seconds >= min_time || iterations >= 1000000000u) {
+                break;
+            }
+            double const scale = seconds > 0 ? 1.4 * min_time / seconds : 10.0;
+            iterations = static_cast<std::size_t>(iterations * std::min(std::max(scale, 2.0), 10.0));
+        }
+        results.push_back({name, iterations, items, seconds});
+
+        table << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed
+              << std::setprecision(1) << seconds * 1e9 / items << " ns" << std::setw(14) << items << std::endl;
+    }
+
+    if (json_path == "-") {
+        write_json(std::cout, results);
+    } else if (!json_path.empty()) {
+        std::ofstream json(json_path);
+        if (!json) {
+            std::cerr << "Unable to open " << json_path << '\n';
+            return 1;
+        }
+        write_json(json, results);
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "bench.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace yadi {
+
+template <bool STATIC>
+struct static_bench_item {
+    std::size_t index;
+};
+
+template <bool STATIC>
+struct factory_traits<static_bench_item<STATIC>> {
+    using ptr_type = static_bench_item<STATIC>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+constexpr std::size_t TYPE_COUNT = 64;
+
+template <std::size_t I>
+struct static_bench_name {
+    static constexpr char value[] = {'t', 'y', 'p', 'e', '_', char('0' + I / 10), char('0' + I % 10), '\0'};
+};
+
+template <bool STATIC, std::size_t I>
+static_bench_item<STATIC> make_item(YAML::Node const&) {
+    return static_bench_item<STATIC>{I};
+}
+
+template <std::size_t... I>
+auto make_registry(std::index_sequence<I...>)
+    -> static_registry<static_bench_item<true>, static_type<static_bench_name<I>::value, &make_item<true, I>>...>;
+
+using item_registry = decltype(make_registry(std::make_index_sequence<TYPE_COUNT>()));
+
+template <std::size_t... I>
+void register_runtime_items(std::index_sequence<I...>) {
+    (register_type<static_bench_item<false>>(static_bench_name<I>::value, &make_item<false, I>), ...);
+    factory<static_bench_item<false>>::freeze();
+}
+
+std::vector<std::string> item_names() {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < TYPE_COUNT; ++i) {
+        names.push_back("type_" + std::to_string(i / 10) + std::to_string(i % 10));
+    }
+    return names;
+}
+
+// Cycles through every name so one hot entry doesn't hide the lookup cost
+template <typename F>
+void create_items(bench::state& state, F create) {
+    std::vector<std::string> const names = item_names();
+    std::size_t i = 0;
+    while (state.keep_running()) {
+        bench::do_not_optimize(create(names[i]));
+        i = (i + 1 == names.size()) ? 0 : i + 1;
+    }
+}
+
+void static_registry_create(bench::state& state) {
+    create_items(state, [](std::string const& name) { return item_registry::create(name); });
+}
+
+void frozen_factory_create(bench::state& state) {
+    create_items(state, [](std::string const& name) { return factory<static_bench_item<false>>::create(name); });
+}
+
+// A name known at compile time resolves without any lookup
+void static_registry_create_constant(bench::state& state) {
+    while (state.keep_running()) {
+        bench::do_not_optimize(item_registry::create_at<item_registry::index_of("type_42")>());
+    }
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+register_runtime_items(std::make_index_sequence<TYPE_COUNT>());
+bench::register_bench("static_registry/create/64", &static_registry_create);
+bench::register_bench("static_registry/frozen_factory/64", &frozen_factory_create);
+bench::register_bench("static_registry/create_constant", &static_registry_create_constant);
+YADI_INIT_END
+
+}  // namespace yadi
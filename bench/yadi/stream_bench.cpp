@@ -0,0 +1,70 @@
+#include "bench.hpp"
+
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+struct stream_bench_rule {
+    stream_bench_rule(std::string name, std::vector<int> ids) : name(std::move(name)), ids(std::move(ids)) {}
+    std::string name;
+    std::vector<int> ids;
+};
+
+namespace {
+
+ptr_type_t<stream_bench_rule> make_stream_bench_rule(std::string name, std::vector<int> ids) {
+    return ctr<stream_bench_rule, stream_bench_rule>(std::move(name), std::move(ids));
+}
+
+std::string rule_configs(std::size_t size) {
+    std::string configs;
+    for (std::size_t i = 0; i < size; ++i) {
+        configs += "- type: stream_rule\n  config:\n    name: rule_" + std::to_string(i) + "\n    ids: [" +
+                   std::to_string(i) + ", " + std::to_string(i + 1) + "]\n";
+    }
+    return configs;
+}
+
+// Time is reported per element, including parsing
+template <std::size_t SIZE>
+void from_yamls_load(bench::state& state) {
+    std::string const configs = rule_configs(SIZE);
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        std::vector<ptr_type_t<stream_bench_rule>> rules;
+        from_yamls<ptr_type_t<stream_bench_rule>>(YAML::Load(configs), std::back_inserter(rules));
+        bench::do_not_optimize(rules);
+    }
+}
+
+template <std::size_t SIZE>
+void from_yaml_stream_sink(bench::state& state) {
+    std::string const configs = rule_configs(SIZE);
+    state.set_items_processed(state.iterations() * SIZE);
+    while (state.keep_running()) {
+        std::vector<ptr_type_t<stream_bench_rule>> rules;
+        from_yaml_stream<ptr_type_t<stream_bench_rule>>(
+            std::string_view(configs), [&rules](ptr_type_t<stream_bench_rule> rule) { rules.push_back(std::move(rule)); });
+        bench::do_not_optimize(rules);
+    }
+}
+
+template <std::size_t SIZE>
+void register_stream_benches() {
+    std::string const size = std::to_string(SIZE);
+    bench::register_bench("from_yamls/load/" + size, &from_yamls_load<SIZE>);
+    bench::register_bench("from_yaml_stream/" + size, &from_yaml_stream_sink<SIZE>);
+}
+
+}  // anonymous namespace
+
+YADI_INIT_BEGIN
+::yadi::register_type<stream_bench_rule>(
+    "stream_rule",
+    make_map_initializer<stream_bench_rule>(&make_stream_bench_rule, std::vector<std::string>{"name", "ids"}));
+register_stream_benches<100>();
+register_stream_benches<10000>();
+YADI_INIT_END
+
+}  // namespace yadi
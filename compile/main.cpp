@@ -0,0 +1,58 @@
+#include "yadi/inspector.hpp"
+
+#include <yadi/yadi.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+int usage() {
+    std::cerr << "Usage: yadi_compile [--validate] <input.yaml> <output>\n";
+    return 2;
+}
+
+}  // anonymous namespace
+
+// Compiles a YAML config to the binary format loaded by config_document::map_file.  With --validate, types are checked
+// against the factories linked into this executable, which are only yadi's own.  Programs validate their configs with
+// validate_config.
+int main(int argc, char** argv) {
+    bool validate = false;
+    int arg = 1;
+    if (arg < argc && std::strcmp(argv[arg], "--validate") == 0) {
+        validate = true;
+        ++arg;
+    }
+    if (argc - arg != 2) {
+        return usage();
+    }
+    char const* const input = argv[arg];
+    char const* const output = argv[arg + 1];
+
+    try {
+        YAML::Node const config = YAML::LoadFile(input);
+        if (validate) {
+            std::vector<std::string> const errors = ::yadi::validate_config(config);
+            for (std::string const& error : errors) {
+                std::cerr << input << ": " << error << '\n';
+            }
+            if (!errors.empty()) {
+                return 1;
+            }
+        }
+
+        ::yadi::config_document const document(config);
+        std::ofstream out(output, std::ios::binary | std::ios::trunc);
+        document.save(out);
+        if (!out.flush()) {
+            std::cerr << "Unable to write " << output << '\n';
+            return 1;
+        }
+    } catch (std::exception const& ex) {
+        std::cerr << input << ": " << ex.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -6,6 +6,96 @@
 
 #include <yadi/yadi.hpp>
 
+#include <cstdint>
+#include <set>
+
+namespace {
+
+std::uint64_t mean_nanoseconds(yadi::create_metrics const& metrics) {
+    return metrics.creates ? metrics.nanoseconds / metrics.creates : 0;
+}
+
+void print_text(std::ostream& out, std::vector<yadi::create_metrics> const& metrics) {
+    std::string const* factory = nullptr;
+    for (yadi::create_metrics const& entry : metrics) {
+        if (!factory || *factory != entry.factory) {
+            factory = &entry.factory;
+            out << entry.factory << '\n';
+        }
+        out << "\t\"" << entry.type << "\" -> " << entry.creates << " creates, " << entry.failures << " failed, mean "
+            << mean_nanoseconds(entry) << " ns, p50 < " << entry.latency_percentile(0.5) << " ns, p99 < "
+            << entry.latency_percentile(0.99) << " ns, " << entry.bytes << " bytes\n";
+    }
+}
+
+void print_json(std::ostream& out, std::vector<yadi::create_metrics> const& metrics) {
+    out << "{\n  \"metrics\": [";
+    for (std::size_t i = 0; i < metrics.size(); ++i) {
+        yadi::create_metrics const& entry = metrics[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"factory\": " << yadi::details::json_string(entry.factory)
+            << ", \"type\": " << yadi::details::json_string(entry.type) << ", \"creates\": " << entry.creates
+            << ", \"failures\": " << entry.failures << ", \"nanoseconds\": " << entry.nanoseconds
+            << ", \"bytes\": " << entry.bytes << ", \"latency\": [";
+        // Bucket counts by upper bound in nanoseconds, empty buckets left out
+        bool first = true;
+        for (std::size_t bucket = 0; bucket < yadi::LATENCY_BUCKETS; ++bucket) {
+            if (entry.latency[bucket]) {
+                out << (first ? "" : ", ") << "{\"below_ns\": " << (std::uint64_t(2) << bucket)
+                    << ", \"count\": " << entry.latency[bucket] << "}";
+                first = false;
+            }
+        }
+        out << "]}";
+    }
+    out << (metrics.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+/**
+ * @brief Whether node is a map of a scalar "type" and optionally "config" and nothing else.  Data that happens to have
+ * a "type" field among others isn't taken for a factory config.
+ */
+bool is_factory_config(YAML::Node const& node) {
+    if (!node.IsMap()) {
+        return false;
+    }
+    bool scalar_type = false;
+    for (auto const& entry : node) {
+        if (!entry.first.IsScalar()) {
+            return false;
+        }
+        if (entry.first.Scalar() == "type") {
+            scalar_type = entry.second.IsScalar();
+        } else if (entry.first.Scalar() != "config") {
+            return false;
+        }
+    }
+    return scalar_type;
+}
+
+void validate_node(YAML::Node const& node, std::set<std::string> const& types, std::vector<std::string>& errors) {
+    if (is_factory_config(node)) {
+        YAML::Node const type = node["type"];
+        if (types.count(type.Scalar()) == 0) {
+            YAML::Mark const mark = type.Mark();
+            errors.push_back("Unknown type \"" + type.Scalar() + "\" at line " + std::to_string(mark.line + 1) +
+                             ", column " + std::to_string(mark.column + 1));
+        }
+        if (YAML::Node const config = node["config"]) {
+            validate_node(config, types, errors);
+        }
+    } else if (node.IsMap()) {
+        for (auto const& entry : node) {
+            validate_node(entry.second, types, errors);
+        }
+    } else if (node.IsSequence()) {
+        for (YAML::Node const& element : node) {
+            validate_node(element, types, errors);
+        }
+    }
+}
+
+}  // anonymous namespace
+
 void yadi::print_factory_help(std::ostream& out) {
     yadi_help::help_store helps = yadi_help::helps();
     for (auto const& entry : helps) {
@@ -16,3 +106,27 @@ void yadi::print_factory_help(std::ostream& out) {
         }
     }
 }
+
+std::vector<std::string> yadi::validate_config(YAML::Node const& config) {
+    std::set<std::string> types;
+    for (auto const& entry : yadi_help::helps()) {
+        std::vector<std::string> factory_types = entry.second.get_types();
+        types.insert(factory_types.begin(), factory_types.end());
+    }
+
+    std::vector<std::string> errors;
+    validate_node(config, types, errors);
+    return errors;
+}
+
+void yadi::print_create_metrics(std::ostream& out, metrics_format format) {
+    print_create_metrics(out, create_metrics_snapshot(), format);
+}
+
+void yadi::print_create_metrics(std::ostream& out, std::vector<create_metrics> const& metrics, metrics_format format) {
+    if (format == metrics_format::json) {
+        print_json(out, metrics);
+    } else {
+        print_text(out, metrics);
+    }
+}
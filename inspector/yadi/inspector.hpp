@@ -5,12 +5,41 @@
 #ifndef YADI_INSPECTOR_HPP
 #define YADI_INSPECTOR_HPP
 
+#include <yaml-cpp/yaml.h>
+
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace yadi {
 
+struct create_metrics;
+
 void print_factory_help(std::ostream& out);
 
+enum class metrics_format { text, json };
+
+/**
+ * @brief Prints create_metrics_snapshot().  Text lists each factory followed by its types, JSON is an object with a
+ * "metrics" array holding an object per type.  Without YADI_INSTRUMENT there's nothing to print.  Metrics are kept per
+ * process, so this is called from the program doing the creates, for example when it exits.
+ */
+void print_create_metrics(std::ostream& out, metrics_format format = metrics_format::text);
+
+/**
+ * @brief Prints metrics, see print_create_metrics(std::ostream&, metrics_format).
+ */
+void print_create_metrics(std::ostream& out, std::vector<create_metrics> const& metrics,
+                          metrics_format format = metrics_format::text);
+
+/**
+ * @brief Finds factory configs in config whose type isn't registered with any factory passed to register_factory, the
+ * factories print_factory_help lists.  A factory config is a map of a scalar "type" and optionally "config", and
+ * nothing else.  Call it from the program whose factories the config is for, other programs don't register them.
+ * @return A message with the line and column of each unknown type, empty if there are none
+ */
+std::vector<std::string> validate_config(YAML::Node const& config);
+
 }  // namespace yadi
 
 #endif  // YADI_INSPECTOR_HPP
@@ -0,0 +1,109 @@
+#include "allocation.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace yadi {
+
+namespace {
+
+thread_local arena* CURRENT_ARENA = nullptr;
+
+// Blocks per slab, a slab is at least this many bytes
+constexpr std::size_t MIN_SLAB_BYTES = 16384;
+constexpr std::size_t MIN_SLAB_BLOCKS = 16;
+
+struct slab_registry {
+    std::mutex mutex;
+    std::map<std::size_t, details::free_block*> free_blocks;  ///< Blocks given back, by block size
+};
+
+slab_registry& slabs() {
+    // Never destroyed, blocks may be freed during static destruction
+    static slab_registry* registry = new slab_registry();
+    return *registry;
+}
+
+}  // anonymous namespace
+
+arena::arena(std::size_t initial_size) : initial_size(initial_size ? initial_size : 1) {}
+
+arena::~arena() {
+    for (auto const& block : this->blocks) {
+        ::operator delete(block.first);
+    }
+}
+
+void* arena::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t const padding = (alignment - reinterpret_cast<std::uintptr_t>(this->next) % alignment) % alignment;
+    if (!this->next || padding + size > static_cast<std::size_t>(this->end - this->next)) {
+        std::size_t block_size = this->blocks.empty() ? this->initial_size : this->blocks.back().second * 2;
+        while (block_size < size + alignment) {
+            block_size *= 2;
+        }
+        char* block = static_cast<char*>(::operator new(block_size));
+        this->blocks.emplace_back(block, block_size);
+        this->next = block;
+        this->end = block + block_size;
+        return this->allocate(size, alignment);
+    }
+    void* ptr = this->next + padding;
+    this->next += padding + size;
+    return ptr;
+}
+
+void arena::release() {
+    if (this->blocks.empty()) {
+        return;
+    }
+    for (std::size_t i = 1; i < this->blocks.size(); ++i) {
+        ::operator delete(this->blocks[i].first);
+    }
+    this->blocks.resize(1);
+    this->next = this->blocks.front().first;
+    this->end = this->next + this->blocks.front().second;
+}
+
+arena* arena::current() { return CURRENT_ARENA; }
+
+arena_scope::arena_scope(arena& scoped) : previous(CURRENT_ARENA) { CURRENT_ARENA = &scoped; }
+
+arena_scope::~arena_scope() { CURRENT_ARENA = this->previous; }
+
+// \cond DEV_DOCS
+namespace details {
+
+free_block* slab_store::take(std::size_t block_size) {
+    slab_registry& registry = slabs();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        free_block*& given = registry.free_blocks[block_size];
+        if (given) {
+            return std::exchange(given, nullptr);
+        }
+    }
+
+    std::size_t const count = std::max(MIN_SLAB_BLOCKS, MIN_SLAB_BYTES / block_size);
+    char* slab = static_cast<char*>(::operator new(count * block_size));
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        reinterpret_cast<free_block*>(slab + i * block_size)->next =
+            reinterpret_cast<free_block*>(slab + (i + 1) * block_size);
+    }
+    reinterpret_cast<free_block*>(slab + (count - 1) * block_size)->next = nullptr;
+    return reinterpret_cast<free_block*>(slab);
+}
+
+void slab_store::give(std::size_t block_size, free_block* head, free_block* tail) {
+    slab_registry& registry = slabs();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    free_block*& given = registry.free_blocks[block_size];
+    tail->next = given;
+    given = head;
+}
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
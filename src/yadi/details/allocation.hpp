@@ -0,0 +1,376 @@
+#ifndef YADI_ALLOCATION_HPP
+#define YADI_ALLOCATION_HPP
+
+#include "metrics.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Deletes an object made by pool_allocation or arena_allocation.  A default constructed deleter uses delete, so
+ * pooled_ptr can also own objects made with new.
+ * @tparam BT The pointed to type
+ */
+template <typename BT>
+class pooled_deleter {
+   public:
+    using destroy_type = void (*)(BT*);
+
+    pooled_deleter() = default;
+
+    explicit pooled_deleter(destroy_type destroy) : destroy(destroy) {}
+
+    void operator()(BT* ptr) const {
+        if (this->destroy) {
+            this->destroy(ptr);
+        } else {
+            delete ptr;
+        }
+    }
+
+   private:
+    destroy_type destroy = nullptr;
+};
+
+/**
+ * @brief Unique pointer for factory_traits<BT>::ptr_type when BT uses pool_allocation or arena_allocation.
+ */
+template <typename BT>
+using pooled_ptr = std::unique_ptr<BT, pooled_deleter<BT>>;
+
+/**
+ * @brief Allocation policy creating each object with new, the default.  The policy of BT is
+ * factory_traits<BT>::allocation.
+ */
+struct new_allocation {
+    template <typename PT, typename IT, typename... ARGS>
+    static PT make(ARGS&&... args) {
+#ifdef YADI_INSTRUMENT
+        record_allocation(sizeof(IT));
+#endif
+        return PT(new IT(std::forward<ARGS>(args)...));
+    }
+};
+
+/**
+ * @brief Monotonic memory for objects created while handling one request.  Allocation bumps a pointer and memory is
+ * only freed, all at once, by release or destruction.  Objects must be destroyed before their memory is released, the
+ * arena doesn't run destructors.  Not thread safe, use one arena per request.
+ */
+class arena {
+   public:
+    /**
+     * @param initial_size Bytes of the first block, later blocks double
+     */
+    explicit arena(std::size_t initial_size = 4096);
+    ~arena();
+
+    arena(arena const&) = delete;
+    arena& operator=(arena const&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    /**
+     * @brief Frees everything allocated.  The first block is kept for reuse.
+     */
+    void release();
+
+    /**
+     * @brief The arena of the innermost arena_scope on this thread, nullptr if there is none.
+     */
+    static arena* current();
+
+   private:
+    std::vector<std::pair<char*, std::size_t>> blocks;
+    char* next = nullptr;
+    char* end = nullptr;
+    std::size_t initial_size;
+};
+
+/**
+ * @brief Makes an arena the one objects of arena_allocation types are created in on this thread, until the scope
+ * ends.  Scopes nest.
+ */
+class arena_scope {
+   public:
+    explicit arena_scope(arena& scoped);
+    ~arena_scope();
+
+    arena_scope(arena_scope const&) = delete;
+    arena_scope& operator=(arena_scope const&) = delete;
+
+   private:
+    arena* previous;
+};
+
+// \cond DEV_DOCS
+namespace details {
+
+struct free_block {
+    free_block* next;
+};
+
+/**
+ * @brief Blocks shared by every thread's slab_pool of a block size.  Slabs are never freed so a block can be released
+ * on any thread.
+ */
+struct slab_store {
+    /**
+     * @brief A list of free blocks, taken from blocks given back or carved from a new slab.
+     */
+    static free_block* take(std::size_t block_size);
+
+    static void give(std::size_t block_size, free_block* head, free_block* tail);
+};
+
+template <std::size_t SIZE>
+inline constexpr std::size_t block_size_v =
+    (SIZE + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+/**
+ * @brief Per thread free list of BLOCK_SIZE blocks.  Blocks freed by another thread join that thread's list, which
+ * is given back when the thread exits.
+ */
+template <std::size_t BLOCK_SIZE>
+class slab_pool {
+   public:
+    static void* allocate() {
+        cache& local = flushed_cache();
+        if (!local.head) {
+            local.head = slab_store::take(BLOCK_SIZE);
+        }
+        free_block* block = local.head;
+        local.head = block->next;
+        if (local.count) {
+            --local.count;
+        }
+        return block;
+    }
+
+    static void deallocate(void* ptr) {
+        cache& local = local_cache();
+        // A thread that only frees gives its blocks back on exit as well
+        if (!local.exited) {
+            flushed_cache();
+        }
+        free_block* block = static_cast<free_block*>(ptr);
+        block->next = local.head;
+        local.head = block;
+        // Bounds what a thread that only frees holds on to, and once it exited nothing is held
+        if (++local.count > MAX_CACHED || local.exited) {
+            local.give_back();
+        }
+    }
+
+   private:
+    static constexpr std::size_t MAX_CACHED = 4096;
+
+    // Trivially destructible so objects freed after the thread's flusher ran still find it
+    struct cache {
+        free_block* head;
+        std::size_t count;  ///< Blocks freed since the list was last given back, a lower bound on its length
+        bool exited;        ///< Set once the flusher ran
+
+        void give_back() {
+            if (this->head) {
+                free_block* tail = this->head;
+                while (tail->next) {
+                    tail = tail->next;
+                }
+                slab_store::give(BLOCK_SIZE, this->head, tail);
+            }
+            this->head = nullptr;
+            this->count = 0;
+        }
+    };
+
+    // Gives the thread's blocks back when it exits
+    struct flusher {
+        ~flusher() {
+            cache& local = local_cache();
+            local.give_back();
+            local.exited = true;
+        }
+    };
+
+    static cache& local_cache() {
+        thread_local cache local{nullptr, 0, false};
+        return local;
+    }
+
+    static cache& flushed_cache() {
+        thread_local flusher flush;
+        (void)flush;
+        return local_cache();
+    }
+};
+
+template <typename T>
+using slab_pool_for = slab_pool<block_size_v<sizeof(T)>>;
+
+/**
+ * @brief Standard allocator over slab_pool, for std::allocate_shared.
+ */
+template <typename T>
+struct pool_allocator {
+    using value_type = T;
+
+    pool_allocator() = default;
+
+    template <typename U>
+    pool_allocator(pool_allocator<U> const&) {}
+
+    T* allocate(std::size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(slab_pool_for<T>::allocate());
+    }
+
+    void deallocate(T* ptr, std::size_t n) {
+        if (n != 1) {
+            ::operator delete(ptr);
+        } else {
+            slab_pool_for<T>::deallocate(ptr);
+        }
+    }
+
+    template <typename U>
+    bool operator==(pool_allocator<U> const&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(pool_allocator<U> const&) const {
+        return false;
+    }
+};
+
+/**
+ * @brief Standard allocator over an arena, for std::allocate_shared.  Deallocation does nothing.
+ */
+template <typename T>
+struct arena_allocator {
+    using value_type = T;
+
+    explicit arena_allocator(arena& memory) : memory(&memory) {}
+
+    template <typename U>
+    arena_allocator(arena_allocator<U> const& other) : memory(other.memory) {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(this->memory->allocate(n * sizeof(T), alignof(T))); }
+
+    void deallocate(T*, std::size_t) {}
+
+    template <typename U>
+    bool operator==(arena_allocator<U> const& other) const {
+        return this->memory == other.memory;
+    }
+
+    template <typename U>
+    bool operator!=(arena_allocator<U> const& other) const {
+        return this->memory != other.memory;
+    }
+
+    arena* memory;
+};
+
+template <typename PT>
+struct is_shared_ptr : std::false_type {};
+
+template <typename T>
+struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {};
+
+template <typename PT>
+struct is_pooled_ptr : std::false_type {};
+
+template <typename T>
+struct is_pooled_ptr<pooled_ptr<T>> : std::true_type {};
+
+template <typename BT, typename IT>
+void destroy_pooled(BT* ptr) {
+    IT* instance = static_cast<IT*>(ptr);
+    instance->~IT();
+    slab_pool_for<IT>::deallocate(instance);
+}
+
+template <typename BT, typename IT>
+void destroy_in_arena(BT* ptr) {
+    static_cast<IT*>(ptr)->~IT();
+}
+
+template <typename PT>
+inline constexpr bool is_policy_ptr_v = is_shared_ptr<PT>::value || is_pooled_ptr<PT>::value;
+
+}  // namespace details
+// \endcond
+
+/**
+ * @brief Allocation policy creating objects from per size slab pools, avoiding the general purpose allocator for
+ * small short lived objects.  ptr_type must be std::shared_ptr<BT>, which uses std::allocate_shared so the object and
+ * control block are one block, or pooled_ptr<BT>.
+ */
+struct pool_allocation {
+    template <typename PT, typename IT, typename... ARGS>
+    static PT make(ARGS&&... args) {
+        static_assert(details::is_policy_ptr_v<PT>, "pool_allocation needs ptr_type std::shared_ptr or pooled_ptr");
+        static_assert(alignof(IT) <= alignof(std::max_align_t), "pool_allocation doesn't support over aligned types");
+#ifdef YADI_INSTRUMENT
+        record_allocation(sizeof(IT));
+#endif
+        if constexpr (details::is_shared_ptr<PT>::value) {
+            return std::allocate_shared<IT>(details::pool_allocator<IT>(), std::forward<ARGS>(args)...);
+        } else {
+            using base_type = typename PT::element_type;
+            void* memory = details::slab_pool_for<IT>::allocate();
+            IT* instance;
+            try {
+                instance = new (memory) IT(std::forward<ARGS>(args)...);
+            } catch (...) {
+                details::slab_pool_for<IT>::deallocate(memory);
+                throw;
+            }
+            return PT(instance, pooled_deleter<base_type>(&details::destroy_pooled<base_type, IT>));
+        }
+    }
+};
+
+/**
+ * @brief Allocation policy creating objects in the arena of the current arena_scope, or with new outside of one.  The
+ * objects must be destroyed before the arena is released.  ptr_type must be std::shared_ptr<BT> or pooled_ptr<BT>.
+ */
+struct arena_allocation {
+    template <typename PT, typename IT, typename... ARGS>
+    static PT make(ARGS&&... args) {
+        static_assert(details::is_policy_ptr_v<PT>, "arena_allocation needs ptr_type std::shared_ptr or pooled_ptr");
+        arena* memory = arena::current();
+        if (!memory) {
+            return new_allocation::make<PT, IT>(std::forward<ARGS>(args)...);
+        }
+#ifdef YADI_INSTRUMENT
+        record_allocation(sizeof(IT));
+#endif
+        if constexpr (details::is_shared_ptr<PT>::value) {
+            return std::allocate_shared<IT>(details::arena_allocator<IT>(*memory), std::forward<ARGS>(args)...);
+        } else {
+            using base_type = typename PT::element_type;
+            // Nothing to undo if construction throws, the arena frees the memory
+            IT* instance = new (memory->allocate(sizeof(IT), alignof(IT))) IT(std::forward<ARGS>(args)...);
+            return PT(instance, pooled_deleter<base_type>(&details::destroy_in_arena<base_type, IT>));
+        }
+    }
+};
+
+}  // namespace yadi
+
+#endif  // YADI_ALLOCATION_HPP
@@ -0,0 +1,148 @@
+#include "batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace yadi {
+
+namespace {
+
+std::string format_errors(std::vector<batch_element_error> const& errors) {
+    std::string message = std::to_string(errors.size()) + " batch element(s) failed";
+    for (batch_element_error const& error : errors) {
+        message += "\n\t[" + std::to_string(error.index) + "] " + error.message;
+    }
+    return message;
+}
+
+/**
+ * @brief Indexes shared out between the caller of parallel_for and pool threads.  Pool threads hold the job by
+ * shared_ptr, so one picking it up after the caller has returned only finds the indexes taken.
+ */
+struct parallel_job {
+    parallel_job(std::size_t count, std::function<void(std::size_t)> const& body) : count(count), body(body) {}
+
+    /**
+     * @brief Runs body for indexes until none are left.
+     */
+    void work() {
+        for (std::size_t index = this->next++; index < this->count; index = this->next++) {
+            this->body(index);
+        }
+    }
+
+    /**
+     * @brief work() from a pool thread, counted so the caller can wait for it.
+     */
+    void help() {
+        ++this->helping;
+        this->work();
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->helping == 0) {
+            this->done.notify_all();
+        }
+    }
+
+    /**
+     * @brief Once every index is taken, waits for pool threads still running body.
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->done.wait(lock, [this]() { return this->helping == 0; });
+    }
+
+    std::size_t const count;
+    std::function<void(std::size_t)> const& body;  ///< Only called while the caller is in parallel_for
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> helping{0};
+    std::mutex mutex;
+    std::condition_variable done;
+};
+
+/**
+ * @brief Threads shared by every parallel_for, started as the largest concurrency asked for grows and kept for the life
+ * of the process.
+ */
+class worker_pool {
+   public:
+    static worker_pool& instance() {
+        // Never destroyed, joining at exit would race the thread_local state of the pool threads with static
+        // destruction.  Idle threads are left waiting when the process exits.
+        static worker_pool* pool = new worker_pool();
+        return *pool;
+    }
+
+    /**
+     * @brief Hands job to up to helpers pool threads.  Starts threads as needed, if one can't be started the job gets
+     * fewer helpers.
+     */
+    void run(std::shared_ptr<parallel_job> const& job, std::size_t helpers) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            try {
+                while (this->threads.size() < helpers) {
+                    this->threads.emplace_back([this]() { this->serve(); });
+                }
+            } catch (std::system_error const&) {
+                helpers = this->threads.size();
+            }
+            for (std::size_t i = 0; i < helpers; ++i) {
+                this->jobs.push_back(job);
+            }
+        }
+        this->ready.notify_all();
+    }
+
+   private:
+    worker_pool() = default;
+
+    void serve() {
+        while (true) {
+            std::shared_ptr<parallel_job> job;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->ready.wait(lock, [this]() { return !this->jobs.empty(); });
+                job = std::move(this->jobs.front());
+                this->jobs.pop_front();
+            }
+            job->help();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::shared_ptr<parallel_job>> jobs;
+    std::vector<std::thread> threads;
+};
+
+}  // anonymous namespace
+
+batch_exception::batch_exception(std::vector<batch_element_error> errors)
+    : std::runtime_error(format_errors(errors)), element_errors(std::move(errors)) {}
+
+void details::parallel_for(std::size_t count, std::size_t concurrency,
+                           std::function<void(std::size_t)> const& body) {
+    if (concurrency == 0) {
+        concurrency = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t const thread_count = std::min(concurrency, count);
+
+    std::shared_ptr<parallel_job> job(new parallel_job(count, body));
+    if (thread_count > 1) {
+        // Any helper that couldn't be handed the job leaves its share to the caller
+        try {
+            worker_pool::instance().run(job, thread_count - 1);
+        } catch (...) {
+        }
+    }
+    job->work();
+    job->wait();
+}
+
+}  // namespace yadi
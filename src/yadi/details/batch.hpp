@@ -0,0 +1,162 @@
+#ifndef YADI_BATCH_HPP
+#define YADI_BATCH_HPP
+
+#include "create_utils.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Failure creating one element of a batch.
+ */
+struct batch_element_error {
+    std::size_t index;      ///< Position of the element in the factory configs
+    std::string message;    ///< what() of the exception
+    std::exception_ptr error;
+};
+
+/**
+ * @brief Thrown by from_yamls_parallel when any element fails.  Holds every failure, ordered by index.
+ */
+class batch_exception : public std::runtime_error {
+   public:
+    explicit batch_exception(std::vector<batch_element_error> errors);
+
+    std::vector<batch_element_error> const& errors() const { return this->element_errors; }
+
+   private:
+    std::vector<batch_element_error> element_errors;
+};
+
+/**
+ * @brief Result of create_batch.  values[i] holds the element created from the ith factory config, or nothing if it
+ * failed, in which case errors has an entry with index i.
+ * @tparam OT
+ */
+template <typename OT>
+struct batch_result {
+    std::vector<std::optional<OT>> values;
+    std::vector<batch_element_error> errors;
+
+    bool ok() const { return this->errors.empty(); }
+};
+
+/**
+ * @brief Creates each element of a sequence of factory configs (anything from_yaml accepts) with from_yaml<OT>,
+ * building independent elements concurrently.  Element failures are collected rather than stopping the batch.
+ *
+ * Elements are read from several threads at once, so the configs must not be modified until this returns and
+ * initializers must not modify the config they are passed.  Creation goes through the same lock free factory lookup as
+ * create, so types may still be registered meanwhile.
+ * @tparam OT The desired output type
+ * @param factory_configs A sequence, or a single factory config which is created as a batch of one
+ * @param concurrency Maximum number of threads to use, including the caller.  0 uses the hardware concurrency.
+ * @return Elements in the order of factory_configs along with any errors
+ */
+template <typename OT>
+batch_result<OT> create_batch(YAML::Node const& factory_configs, std::size_t concurrency = 0);
+
+/**
+ * @brief Parallel from_yamls.  Populates out in the order of factory_configs once every element is created.
+ * @tparam OT The desired output type
+ * @tparam OI Output iterator
+ * @param factory_configs
+ * @param out
+ * @param concurrency See create_batch
+ * @throws batch_exception If any element fails, in which case nothing is written to out
+ */
+template <typename OT, typename OI>
+void from_yamls_parallel(YAML::Node const& factory_configs, OI out, std::size_t concurrency = 0);
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief Calls body for each index in [0, count) on up to concurrency threads, the caller being one of them and the
+ * rest taken from a pool shared by every call.  Indexes are handed out one at a time so long running elements don't
+ * hold up the rest, and any the pool can't help with are run by the caller.  body must not throw.
+ * @param count
+ * @param concurrency 0 uses the hardware concurrency
+ * @param body
+ */
+void parallel_for(std::size_t count, std::size_t concurrency, std::function<void(std::size_t)> const& body);
+
+}  // namespace details
+// \endcond
+
+// ################### IMPL ######################
+
+template <typename OT>
+batch_result<OT> create_batch(YAML::Node const& factory_configs, std::size_t concurrency) {
+    if (!factory_configs.IsDefined()) {
+        throw std::runtime_error("From YAML factory configs not defined");
+    }
+
+    // Elements are gathered up front since iterating the sequence isn't safe from several threads
+    std::vector<YAML::Node> configs;
+    if (factory_configs.IsSequence()) {
+        configs.reserve(factory_configs.size());
+        for (YAML::Node const& entry : factory_configs) {
+            configs.push_back(entry);
+        }
+    } else {
+        configs.push_back(factory_configs);
+    }
+
+    batch_result<OT> result;
+    result.values.resize(configs.size());
+    std::vector<std::exception_ptr> failures(configs.size());
+    details::parallel_for(configs.size(), concurrency, [&configs, &result, &failures](std::size_t index) {
+        try {
+            result.values[index].emplace(from_yaml<OT>(configs[index]));
+        } catch (...) {
+            failures[index] = std::current_exception();
+        }
+    });
+
+    for (std::size_t index = 0; index < failures.size(); ++index) {
+        if (!failures[index]) {
+            continue;
+        }
+        std::string message = "Unknown error";
+        try {
+            std::rethrow_exception(failures[index]);
+        } catch (std::exception const& ex) {
+            message = ex.what();
+        } catch (...) {
+        }
+        result.errors.push_back({index, std::move(message), failures[index]});
+    }
+
+    return result;
+}
+
+template <typename OT, typename OI>
+void from_yamls_parallel(YAML::Node const& factory_configs, OI out, std::size_t concurrency) {
+    batch_result<OT> result = create_batch<OT>(factory_configs, concurrency);
+    if (!result.ok()) {
+        throw batch_exception(std::move(result.errors));
+    }
+
+    for (std::optional<OT>& value : result.values) {
+        *out = std::move(*value);
+        ++out;
+    }
+}
+
+}  // namespace yadi
+
+#endif  // YADI_BATCH_HPP
@@ -0,0 +1,200 @@
+#ifndef YADI_CONCURRENT_STORE_HPP
+#define YADI_CONCURRENT_STORE_HPP
+
+#include "perfect_hash.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief String keyed store where find never takes a lock and never waits on a writer.  Writers must be serialized by
+ * the caller.
+ *
+ * Keys live in an open addressing table of node pointers.  A slot goes from empty to a node exactly once, and a node's
+ * value pointer is swapped atomically when a key is assigned again.  When the table fills past half a larger one is
+ * built and published as a whole.  Retired tables and replaced values are kept until the store is destroyed, since a
+ * reader may still be using them, which bounds the extra memory to the number of assignments made.
+ * @tparam V value type
+ */
+template <typename V>
+class concurrent_store {
+   public:
+    concurrent_store() : current(nullptr) { this->publish(16); }
+
+    concurrent_store(concurrent_store const&) = delete;
+    concurrent_store& operator=(concurrent_store const&) = delete;
+
+    /**
+     * @brief Lock free lookup.
+     * @param key
+     * @return The value assigned to key or nullptr.  The value remains valid for the life of the store.
+     */
+    V const* find(std::string_view key) const {
+        table const* t = this->current.load(std::memory_order_acquire);
+        std::uint64_t const hash = hash_string(key);
+        for (std::uint64_t i = hash & t->mask;; i = (i + 1) & t->mask) {
+            node const* n = t->slots[i].load(std::memory_order_acquire);
+            if (!n) {
+                return nullptr;
+            }
+            if (n->hash == hash && n->key == key) {
+                return n->value.load(std::memory_order_acquire);
+            }
+        }
+    }
+
+    /**
+     * @brief Assigns value to key.  Calls must be serialized with each other, but not with find.
+     * @param key
+     * @param value
+     * @return The stored value.
+     */
+    V const* assign(std::string_view key, V value) {
+        this->values.emplace_back(new V(std::move(value)));
+        V const* stored = this->values.back().get();
+
+        std::uint64_t const hash = hash_string(key);
+        table* t = this->tables.back().get();
+        std::uint64_t i = hash & t->mask;
+        for (node* n = t->slots[i].load(std::memory_order_relaxed); n;
+             i = (i + 1) & t->mask, n = t->slots[i].load(std::memory_order_relaxed)) {
+            if (n->hash == hash && n->key == key) {
+                n->value.store(stored, std::memory_order_release);
+                return stored;
+            }
+        }
+
+        this->nodes.emplace_back(new node{std::string(key), hash, {stored}});
+        if (this->nodes.size() * 2 > t->mask + 1) {
+            // The new node is placed while building the larger table
+            this->publish((t->mask + 1) * 2);
+        } else {
+            t->slots[i].store(this->nodes.back().get(), std::memory_order_release);
+        }
+        return stored;
+    }
+
+    /**
+     * @brief Number of keys.  Not synchronized with assign.
+     * @return
+     */
+    std::size_t size() const { return this->nodes.size(); }
+
+   private:
+    struct node {
+        std::string const key;
+        std::uint64_t const hash;
+        std::atomic<V const*> value;
+    };
+
+    struct table {
+        explicit table(std::size_t slot_count) : mask(slot_count - 1), slots(new std::atomic<node*>[slot_count]) {
+            for (std::size_t i = 0; i < slot_count; ++i) {
+                this->slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        std::uint64_t const mask;
+        std::unique_ptr<std::atomic<node*>[]> slots;
+    };
+
+    void publish(std::size_t slot_count) {
+        std::unique_ptr<table> t(new table(slot_count));
+        for (auto const& n : this->nodes) {
+            std::uint64_t i = n->hash & t->mask;
+            while (t->slots[i].load(std::memory_order_relaxed)) {
+                i = (i + 1) & t->mask;
+            }
+            t->slots[i].store(n.get(), std::memory_order_relaxed);
+        }
+        this->current.store(t.get(), std::memory_order_release);
+        this->tables.push_back(std::move(t));
+    }
+
+    std::atomic<table const*> current;
+    std::vector<std::unique_ptr<table>> tables;
+    std::vector<std::unique_ptr<node>> nodes;
+    std::vector<std::unique_ptr<V const>> values;
+};
+
+/**
+ * @brief Index keyed counterpart of concurrent_store for dense indexes.  find never takes a lock, writers must be
+ * serialized by the caller.  Values are not owned, the caller keeps them alive for the life of the table.  Growing
+ * copies the slots into a larger table which is published as a whole, retired tables are kept like concurrent_store.
+ * @tparam V value type
+ */
+template <typename V>
+class concurrent_table {
+   public:
+    concurrent_table() : current(nullptr) {}
+
+    concurrent_table(concurrent_table const&) = delete;
+    concurrent_table& operator=(concurrent_table const&) = delete;
+
+    /**
+     * @brief Lock free lookup.
+     * @param index
+     * @return The value assigned to index or nullptr.
+     */
+    V const* find(std::size_t index) const {
+        table const* t = this->current.load(std::memory_order_acquire);
+        return (t && index < t->size) ? t->slots[index].load(std::memory_order_acquire) : nullptr;
+    }
+
+    /**
+     * @brief Assigns value to index.  Calls must be serialized with each other, but not with find.
+     * @param index
+     * @param value
+     */
+    void assign(std::size_t index, V const* value) {
+        table const* t = this->current.load(std::memory_order_relaxed);
+        if (!t || index >= t->size) {
+            std::size_t size = t ? t->size : 16;
+            while (size <= index) {
+                size *= 2;
+            }
+            std::unique_ptr<table> grown(new table(size));
+            for (std::size_t i = 0; t && i < t->size; ++i) {
+                grown->slots[i].store(t->slots[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            t = grown.get();
+            this->tables.push_back(std::move(grown));
+        }
+        t->slots[index].store(value, std::memory_order_release);
+        this->current.store(t, std::memory_order_release);
+    }
+
+   private:
+    struct table {
+        explicit table(std::size_t size) : size(size), slots(new std::atomic<V const*>[size]) {
+            for (std::size_t i = 0; i < size; ++i) {
+                this->slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        std::size_t const size;
+        std::unique_ptr<std::atomic<V const*>[]> slots;
+    };
+
+    std::atomic<table const*> current;
+    std::vector<std::unique_ptr<table>> tables;
+};
+
+}  // namespace details
+// \endcond
+}  // namespace yadi
+
+#endif  // YADI_CONCURRENT_STORE_HPP
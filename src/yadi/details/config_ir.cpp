@@ -0,0 +1,628 @@
+#include "config_ir.hpp"
+#include "perfect_hash.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define YADI_HAS_MMAP
+#endif
+
+namespace yadi {
+
+namespace {
+
+constexpr char CONFIG_MAGIC[8] = {'Y', 'A', 'D', 'I', 'C', 'F', 'G', '\0'};
+constexpr std::uint32_t CONFIG_VERSION = 1;
+// Reads back differently on a machine with the other byte order
+constexpr std::uint32_t CONFIG_BYTE_ORDER = 0x01020304;
+
+// Maps at or below this size are searched by scanning their entries instead of the sorted index
+constexpr std::uint32_t SMALL_MAP_SIZE = 8;
+
+// The non-specific tag yaml-cpp gives plain scalars, stored as string id 1 so most nodes share it
+std::string const PLAIN_TAG = "?";
+
+std::size_t align(std::size_t offset) { return (offset + 7) & ~std::size_t(7); }
+
+/**
+ * @brief Flattens a YAML tree into the vectors that make up the sections of a config buffer.
+ */
+class config_builder {
+   public:
+    config_builder() {
+        this->intern("");
+        this->intern(PLAIN_TAG);
+    }
+
+    std::uint32_t add(YAML::Node const& yaml) {
+        std::uint32_t const index = static_cast<std::uint32_t>(this->nodes.size());
+        this->nodes.emplace_back();
+        details::config_node_data node{};
+        node.type = static_cast<std::uint8_t>(yaml.Type());
+        node.tag = this->intern(yaml.Tag());
+        node.line = yaml.Mark().line;
+        node.column = yaml.Mark().column;
+
+        switch (yaml.Type()) {
+            case YAML::NodeType::Undefined:
+            case YAML::NodeType::Null:
+                break;
+            case YAML::NodeType::Scalar:
+                node.first = this->intern(yaml.Scalar());
+                convert_scalar(yaml, node);
+                break;
+            case YAML::NodeType::Sequence: {
+                // The children's range is claimed before adding them, since each adds its own children after it
+                node.first = static_cast<std::uint32_t>(this->children.size());
+                node.size = static_cast<std::uint32_t>(yaml.size());
+                this->children.resize(this->children.size() + node.size);
+                std::uint32_t child = node.first;
+                for (YAML::Node const& element : yaml) {
+                    std::uint32_t const element_index = this->add(element);
+                    this->children[child++] = element_index;
+                }
+                break;
+            }
+            case YAML::NodeType::Map: {
+                node.first = static_cast<std::uint32_t>(this->entries.size());
+                node.size = static_cast<std::uint32_t>(yaml.size());
+                this->entries.resize(this->entries.size() + node.size);
+                std::uint32_t entry = node.first;
+                for (auto const& element : yaml) {
+                    if (!element.first.IsScalar()) {
+                        throw std::runtime_error("Config map keys must be scalars");
+                    }
+                    std::uint32_t const key = this->intern(element.first.Scalar());
+                    std::uint32_t const value = this->add(element.second);
+                    this->entries[entry++] = {key, value};
+                }
+                if (node.size > SMALL_MAP_SIZE) {
+                    node.sorted = this->sort_entries(node.first, node.size);
+                }
+                break;
+            }
+        }
+
+        this->nodes[index] = node;
+        return index;
+    }
+
+    /**
+     * @brief Lays out the sections in a single buffer.
+     */
+    std::shared_ptr<details::config_sections const> build(std::uint32_t root) const {
+        std::size_t const slot_count = this->slot_count();
+        std::vector<std::uint32_t> slots(slot_count, 0);
+        for (std::uint32_t id = 0; id < this->strings.size() - 1; ++id) {
+            std::size_t slot = details::hash_string(this->string(id)) & (slot_count - 1);
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & (slot_count - 1);
+            }
+            slots[slot] = id + 1;
+        }
+
+        details::config_header header{};
+        std::memcpy(header.magic, CONFIG_MAGIC, sizeof(CONFIG_MAGIC));
+        header.version = CONFIG_VERSION;
+        header.byte_order = CONFIG_BYTE_ORDER;
+        header.root = root;
+        header.node_count = static_cast<std::uint32_t>(this->nodes.size());
+        header.child_count = static_cast<std::uint32_t>(this->children.size());
+        header.entry_count = static_cast<std::uint32_t>(this->entries.size());
+        header.sorted_count = static_cast<std::uint32_t>(this->sorted.size());
+        header.string_count = static_cast<std::uint32_t>(this->strings.size() - 1);
+        header.string_slot_count = static_cast<std::uint32_t>(slot_count);
+        header.char_count = this->chars.size();
+
+        std::size_t offset = align(sizeof(header));
+        auto place = [&offset](std::uint64_t& section_offset, std::size_t bytes) {
+            section_offset = offset;
+            offset = align(offset + bytes);
+        };
+        place(header.nodes_offset, this->nodes.size() * sizeof(details::config_node_data));
+        place(header.children_offset, this->children.size() * sizeof(std::uint32_t));
+        place(header.entries_offset, this->entries.size() * sizeof(details::config_entry_data));
+        place(header.sorted_offset, this->sorted.size() * sizeof(std::uint32_t));
+        place(header.strings_offset, this->strings.size() * sizeof(std::uint64_t));
+        place(header.string_slots_offset, slots.size() * sizeof(std::uint32_t));
+        place(header.chars_offset, this->chars.size());
+        header.size = offset;
+
+        // Allocated as 64 bit words so every section is aligned
+        std::shared_ptr<std::uint64_t> storage(new std::uint64_t[offset / sizeof(std::uint64_t)](),
+                                               std::default_delete<std::uint64_t[]>());
+        char* buffer = reinterpret_cast<char*>(storage.get());
+        auto copy = [buffer](std::uint64_t section_offset, auto const& section) {
+            if (!section.empty()) {
+                std::memcpy(buffer + section_offset, section.data(), section.size() * sizeof(section[0]));
+            }
+        };
+        std::memcpy(buffer, &header, sizeof(header));
+        copy(header.nodes_offset, this->nodes);
+        copy(header.children_offset, this->children);
+        copy(header.entries_offset, this->entries);
+        copy(header.sorted_offset, this->sorted);
+        copy(header.strings_offset, this->strings);
+        copy(header.string_slots_offset, slots);
+        copy(header.chars_offset, this->chars);
+
+        return details::make_config_sections(std::move(storage), offset);
+    }
+
+   private:
+    std::uint32_t intern(std::string const& str) {
+        auto const found = this->ids.find(str);
+        if (found != this->ids.end()) {
+            return found->second;
+        }
+        std::uint32_t const id = static_cast<std::uint32_t>(this->strings.size() - 1);
+        this->ids.emplace(str, id);
+        this->chars += str;
+        this->strings.push_back(this->chars.size());
+        return id;
+    }
+
+    std::string_view string(std::uint32_t id) const {
+        return std::string_view(this->chars).substr(this->strings[id], this->strings[id + 1] - this->strings[id]);
+    }
+
+    // Entry positions of the map ordered by key, ties by position so a lookup finds the first of repeated keys
+    std::uint32_t sort_entries(std::uint32_t first, std::uint32_t size) {
+        std::uint32_t const sorted_first = static_cast<std::uint32_t>(this->sorted.size());
+        for (std::uint32_t position = 0; position < size; ++position) {
+            this->sorted.push_back(position);
+        }
+        std::stable_sort(this->sorted.begin() + sorted_first, this->sorted.end(),
+                         [this, first](std::uint32_t left, std::uint32_t right) {
+                             return this->entries[first + left].key < this->entries[first + right].key;
+                         });
+        return sorted_first;
+    }
+
+    // Power of two with at least half the slots empty
+    std::size_t slot_count() const {
+        std::size_t count = 2;
+        while (count < 2 * (this->strings.size() - 1)) {
+            count *= 2;
+        }
+        return count;
+    }
+
+    static void convert_scalar(YAML::Node const& yaml, details::config_node_data& node) {
+        // Numbers start with a digit, sign or dot and bools with a letter, anything else converts to neither.  The
+        // check saves building a stream for each conversion that would fail.
+        std::string const& scalar = yaml.Scalar();
+        if (scalar.empty()) {
+            return;
+        }
+        char const first = scalar.front();
+        bool const maybe_number = std::isdigit(static_cast<unsigned char>(first)) || first == '-' || first == '+' ||
+                                  first == '.';
+        bool const maybe_bool = std::isalpha(static_cast<unsigned char>(first));
+        if (!maybe_number && !maybe_bool) {
+            return;
+        }
+
+        long long int_value = 0;
+        unsigned long long uint_value = 0;
+        double double_value = 0;
+        float float_value = 0;
+        bool bool_value = false;
+        if (maybe_number && YAML::convert<long long>::decode(yaml, int_value)) {
+            node.flags |= details::CONFIG_INT;
+            node.int_value = int_value;
+        }
+        if (maybe_number && YAML::convert<unsigned long long>::decode(yaml, uint_value)) {
+            // Both only differ for values past the signed range, which are stored as the unsigned bits
+            node.flags |= details::CONFIG_UINT;
+            node.int_value = static_cast<std::int64_t>(uint_value);
+        }
+        // Also infinity and NaN, spelled .inf and .nan
+        if (maybe_number && YAML::convert<double>::decode(yaml, double_value)) {
+            node.flags |= details::CONFIG_DOUBLE;
+            node.double_value = double_value;
+        }
+        if (maybe_number && YAML::convert<float>::decode(yaml, float_value)) {
+            node.flags |= details::CONFIG_FLOAT;
+            node.float_value = float_value;
+        }
+        if (maybe_bool && YAML::convert<bool>::decode(yaml, bool_value)) {
+            node.flags |= details::CONFIG_BOOL;
+            node.int_value = bool_value ? 1 : 0;
+        }
+    }
+
+    std::vector<details::config_node_data> nodes;
+    std::vector<std::uint32_t> children;
+    std::vector<details::config_entry_data> entries;
+    std::vector<std::uint32_t> sorted;
+    std::vector<std::uint64_t> strings{0};
+    std::string chars;
+    std::unordered_map<std::string, std::uint32_t> ids;
+};
+
+details::config_sections const& null_sections() {
+    static std::shared_ptr<details::config_sections const> const SECTIONS = []() {
+        config_builder builder;
+        return builder.build(builder.add(YAML::Node()));
+    }();
+    return *SECTIONS;
+}
+
+[[noreturn]] void throw_invalid(std::string const& reason) {
+    throw std::runtime_error("Invalid config buffer, " + reason);
+}
+
+// Whether count elements of element_size bytes at offset fit in size bytes, without overflowing
+bool fits(std::uint64_t offset, std::uint64_t count, std::size_t element_size, std::size_t size) {
+    return offset % alignof(std::uint64_t) == 0 && offset <= size && count <= (size - offset) / element_size;
+}
+
+void check_header(char const* buffer, std::size_t size) {
+    if (size < sizeof(details::config_header)) {
+        throw_invalid("too small");
+    }
+    details::config_header const& header = *reinterpret_cast<details::config_header const*>(buffer);
+    if (std::memcmp(header.magic, CONFIG_MAGIC, sizeof(CONFIG_MAGIC)) != 0) {
+        throw_invalid("not a yadi config");
+    }
+    if (header.byte_order != CONFIG_BYTE_ORDER) {
+        throw_invalid("written with a different byte order");
+    }
+    if (header.version != CONFIG_VERSION) {
+        throw_invalid("version " + std::to_string(header.version) + " isn't supported");
+    }
+    if (header.size > size || header.root >= header.node_count || header.string_count == 0 ||
+        header.string_slot_count <= header.string_count ||
+        (header.string_slot_count & (header.string_slot_count - 1)) != 0 ||
+        !fits(header.nodes_offset, header.node_count, sizeof(details::config_node_data), size) ||
+        !fits(header.children_offset, header.child_count, sizeof(std::uint32_t), size) ||
+        !fits(header.entries_offset, header.entry_count, sizeof(details::config_entry_data), size) ||
+        !fits(header.sorted_offset, header.sorted_count, sizeof(std::uint32_t), size) ||
+        !fits(header.strings_offset, std::uint64_t(header.string_count) + 1, sizeof(std::uint64_t), size) ||
+        !fits(header.string_slots_offset, header.string_slot_count, sizeof(std::uint32_t), size) ||
+        !fits(header.chars_offset, 0, 1, size) || header.char_count > size - header.chars_offset) {
+        throw_invalid("section out of range");
+    }
+}
+
+// Every index is checked against the size of what it indexes, and children against their parent so nodes can't form
+// a cycle
+void check_sections(details::config_sections const& sections) {
+    details::config_header const& header = *sections.header;
+    for (std::uint32_t id = 0; id < header.string_count; ++id) {
+        if (sections.strings[id] > sections.strings[id + 1]) {
+            throw_invalid("string out of range");
+        }
+    }
+    if (sections.strings[header.string_count] > header.char_count) {
+        throw_invalid("string out of range");
+    }
+    // Each string is in the table once, and an empty slot ends every probe
+    std::vector<bool> slotted(std::size_t(header.string_count) + 1, false);
+    for (std::uint32_t slot = 0; slot < header.string_slot_count; ++slot) {
+        std::uint32_t const id = sections.string_slots[slot];
+        if (id > header.string_count) {
+            throw_invalid("string out of range");
+        }
+        if (id != 0 && slotted[id]) {
+            throw_invalid("string repeated in lookup table");
+        }
+        slotted[id] = true;
+    }
+    if (!slotted[0]) {
+        throw_invalid("string lookup table full");
+    }
+
+    for (std::uint32_t index = 0; index < header.node_count; ++index) {
+        details::config_node_data const& node = sections.nodes[index];
+        if (node.tag >= header.string_count) {
+            throw_invalid("string out of range");
+        }
+        switch (node.type) {
+            case YAML::NodeType::Undefined:
+            case YAML::NodeType::Null:
+                break;
+            case YAML::NodeType::Scalar:
+                if (node.first >= header.string_count) {
+                    throw_invalid("string out of range");
+                }
+                break;
+            case YAML::NodeType::Sequence:
+                if (node.first > header.child_count || node.size > header.child_count - node.first) {
+                    throw_invalid("sequence out of range");
+                }
+                for (std::uint32_t child = node.first; child < node.first + node.size; ++child) {
+                    if (sections.children[child] <= index || sections.children[child] >= header.node_count) {
+                        throw_invalid("node out of range");
+                    }
+                }
+                break;
+            case YAML::NodeType::Map:
+                if (node.first > header.entry_count || node.size > header.entry_count - node.first) {
+                    throw_invalid("map out of range");
+                }
+                for (std::uint32_t entry = node.first; entry < node.first + node.size; ++entry) {
+                    details::config_entry_data const& data = sections.entries[entry];
+                    if (data.key >= header.string_count) {
+                        throw_invalid("string out of range");
+                    }
+                    if (data.value <= index || data.value >= header.node_count) {
+                        throw_invalid("node out of range");
+                    }
+                }
+                if (node.size > SMALL_MAP_SIZE) {
+                    if (node.sorted > header.sorted_count || node.size > header.sorted_count - node.sorted) {
+                        throw_invalid("map index out of range");
+                    }
+                    for (std::uint32_t position = node.sorted; position < node.sorted + node.size; ++position) {
+                        if (sections.sorted[position] >= node.size) {
+                            throw_invalid("map index out of range");
+                        }
+                    }
+                }
+                break;
+            default:
+                throw_invalid("unknown node type");
+        }
+    }
+}
+
+}  // anonymous namespace
+
+// \cond DEV_DOCS
+namespace details {
+
+std::shared_ptr<config_sections const> make_config_sections(std::shared_ptr<void const> storage, std::size_t size) {
+    char const* buffer = static_cast<char const*>(storage.get());
+    if (!buffer || reinterpret_cast<std::uintptr_t>(buffer) % alignof(std::uint64_t) != 0) {
+        throw std::runtime_error("Config buffer must be 8 byte aligned");
+    }
+    check_header(buffer, size);
+
+    std::shared_ptr<config_sections> sections(new config_sections());
+    sections->header = reinterpret_cast<config_header const*>(buffer);
+    sections->nodes = reinterpret_cast<config_node_data const*>(buffer + sections->header->nodes_offset);
+    sections->children = reinterpret_cast<std::uint32_t const*>(buffer + sections->header->children_offset);
+    sections->entries = reinterpret_cast<config_entry_data const*>(buffer + sections->header->entries_offset);
+    sections->sorted = reinterpret_cast<std::uint32_t const*>(buffer + sections->header->sorted_offset);
+    sections->strings = reinterpret_cast<std::uint64_t const*>(buffer + sections->header->strings_offset);
+    sections->chars = buffer + sections->header->chars_offset;
+    sections->string_slots = reinterpret_cast<std::uint32_t const*>(buffer + sections->header->string_slots_offset);
+    sections->storage = std::move(storage);
+    check_sections(*sections);
+    return sections;
+}
+
+std::uint32_t config_sections::find_string(std::string_view str) const {
+    std::uint32_t const mask = this->header->string_slot_count - 1;
+    // Bounded as well as ended by an empty slot, which check_sections makes sure of
+    std::uint32_t slot = hash_string(str) & mask;
+    for (std::uint32_t probe = 0; probe < this->header->string_slot_count; ++probe, slot = (slot + 1) & mask) {
+        std::uint32_t const id = this->string_slots[slot];
+        if (id == 0) {
+            return npos;
+        }
+        if (this->string(id - 1) == str) {
+            return id - 1;
+        }
+    }
+    return npos;
+}
+
+}  // namespace details
+// \endcond
+
+config_node config_node::null() {
+    details::config_sections const& sections = null_sections();
+    return {&sections, sections.header->root};
+}
+
+YAML::NodeType::value config_node::Type() const {
+    return this->sections ? static_cast<YAML::NodeType::value>(this->data().type) : YAML::NodeType::Undefined;
+}
+
+std::size_t config_node::size() const {
+    if (!this->sections) {
+        return 0;
+    }
+    details::config_node_data const& node = this->data();
+    return (node.type == YAML::NodeType::Sequence || node.type == YAML::NodeType::Map) ? node.size : 0;
+}
+
+std::string_view config_node::Scalar() const {
+    return this->IsScalar() ? this->sections->string(this->data().first) : std::string_view();
+}
+
+std::string_view config_node::Tag() const {
+    return this->sections ? this->sections->string(this->data().tag) : std::string_view();
+}
+
+YAML::Mark config_node::Mark() const {
+    if (!this->sections) {
+        return YAML::Mark::null_mark();
+    }
+    YAML::Mark mark;
+    mark.line = this->data().line;
+    mark.column = this->data().column;
+    return mark;
+}
+
+config_node config_node::operator[](std::size_t index) const {
+    if (!this->IsSequence() || index >= this->data().size) {
+        return {};
+    }
+    return {this->sections, this->sections->children[this->data().first + index]};
+}
+
+config_node config_node::operator[](std::string_view key) const {
+    if (!this->IsMap()) {
+        return {};
+    }
+    std::uint32_t const id = this->sections->find_string(key);
+    if (id == details::config_sections::npos) {
+        return {};
+    }
+
+    details::config_node_data const& node = this->data();
+    details::config_entry_data const* entries = this->sections->entries + node.first;
+    if (node.size <= SMALL_MAP_SIZE) {
+        for (std::uint32_t position = 0; position < node.size; ++position) {
+            if (entries[position].key == id) {
+                return {this->sections, entries[position].value};
+            }
+        }
+        return {};
+    }
+
+    std::uint32_t const* sorted = this->sections->sorted + node.sorted;
+    std::uint32_t const* match = std::lower_bound(
+        sorted, sorted + node.size, id, [entries](std::uint32_t position, std::uint32_t key) {
+            return entries[position].key < key;
+        });
+    if (match == sorted + node.size || entries[*match].key != id) {
+        return {};
+    }
+    return {this->sections, entries[*match].value};
+}
+
+YAML::Node config_node::to_yaml() const {
+    switch (this->Type()) {
+        case YAML::NodeType::Undefined:
+            return YAML::Node(YAML::NodeType::Undefined);
+        case YAML::NodeType::Null:
+            return YAML::Node(YAML::NodeType::Null);
+        case YAML::NodeType::Scalar: {
+            YAML::Node yaml(std::string(this->Scalar()));
+            yaml.SetTag(std::string(this->Tag()));
+            return yaml;
+        }
+        case YAML::NodeType::Sequence: {
+            YAML::Node yaml(YAML::NodeType::Sequence);
+            for (config_entry const& element : *this) {
+                yaml.push_back(element.to_yaml());
+            }
+            yaml.SetTag(std::string(this->Tag()));
+            return yaml;
+        }
+        case YAML::NodeType::Map: {
+            YAML::Node yaml(YAML::NodeType::Map);
+            for (config_entry const& entry : *this) {
+                yaml.force_insert(std::string(entry.first.Scalar()), entry.second.to_yaml());
+            }
+            yaml.SetTag(std::string(this->Tag()));
+            return yaml;
+        }
+    }
+    return {};
+}
+
+config_node::iterator config_node::begin() const { return iterator(*this, 0); }
+
+config_node::iterator config_node::end() const { return iterator(*this, static_cast<std::uint32_t>(this->size())); }
+
+void config_node::iterator::load() {
+    if (this->position >= this->node.size()) {
+        this->current = config_entry();
+        return;
+    }
+
+    details::config_sections const* sections = this->node.sections;
+    details::config_node_data const& data = this->node.data();
+    if (data.type == YAML::NodeType::Sequence) {
+        this->current = config_entry(config_node(sections, sections->children[data.first + this->position]));
+    } else {
+        details::config_entry_data const& entry = sections->entries[data.first + this->position];
+        this->current = config_entry(config_key{sections->string(entry.key)}, config_node(sections, entry.value));
+    }
+}
+
+config_document::config_document(YAML::Node const& yaml) {
+    config_builder builder;
+    std::uint32_t const root = builder.add(yaml);
+    this->sections = builder.build(root);
+}
+
+config_document config_document::load(std::string const& yaml) { return config_document(YAML::Load(yaml)); }
+
+config_document config_document::from_buffer(std::shared_ptr<void const> buffer, std::size_t size) {
+    config_document document;
+    document.sections = details::make_config_sections(std::move(buffer), size);
+    return document;
+}
+
+config_document config_document::map_file(std::string const& path) {
+#ifdef YADI_HAS_MMAP
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open config \"" + path + "\"");
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 || status.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to read config \"" + path + "\"");
+    }
+    std::size_t const size = static_cast<std::size_t>(status.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping holds its own reference to the file
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Unable to map config \"" + path + "\"");
+    }
+    std::shared_ptr<void const> buffer(mapped, [size](void const* memory) {
+        ::munmap(const_cast<void*>(memory), size);
+    });
+    try {
+        return from_buffer(std::move(buffer), size);
+    } catch (std::exception const& ex) {
+        throw std::runtime_error("Unable to load config \"" + path + "\": " + ex.what());
+    }
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Unable to open config \"" + path + "\"");
+    }
+    std::size_t const size = static_cast<std::size_t>(file.tellg());
+    std::shared_ptr<std::uint64_t> buffer(new std::uint64_t[(size + 7) / 8](), std::default_delete<std::uint64_t[]>());
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Unable to read config \"" + path + "\"");
+    }
+    try {
+        return from_buffer(std::move(buffer), size);
+    } catch (std::exception const& ex) {
+        throw std::runtime_error("Unable to load config \"" + path + "\": " + ex.what());
+    }
+#endif
+}
+
+void config_document::save(std::ostream& out) const {
+    if (!this->sections) {
+        throw std::runtime_error("Unable to save an empty config document");
+    }
+    out.write(static_cast<char const*>(this->data()), static_cast<std::streamsize>(this->size()));
+}
+
+config_node config_document::root() const {
+    if (!this->sections) {
+        return {};
+    }
+    return {this->sections.get(), this->sections->header->root};
+}
+
+void const* config_document::data() const { return this->sections ? this->sections->header : nullptr; }
+
+std::size_t config_document::size() const { return this->sections ? this->sections->header->size : 0; }
+
+}  // namespace yadi
@@ -0,0 +1,433 @@
+#ifndef YADI_CONFIG_IR_HPP
+#define YADI_CONFIG_IR_HPP
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+class config_document;
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief Start of a config buffer.  Sections are found by offset from the start of the buffer so the buffer can be
+ * copied or mapped anywhere.  Values are in the byte order of the machine that wrote the buffer.
+ */
+struct config_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;  ///< CONFIG_BYTE_ORDER as written
+    std::uint32_t root;
+    std::uint32_t node_count;
+    std::uint32_t child_count;
+    std::uint32_t entry_count;
+    std::uint32_t sorted_count;
+    std::uint32_t string_count;
+    std::uint32_t string_slot_count;
+    std::uint32_t reserved;
+    std::uint64_t char_count;
+    std::uint64_t nodes_offset;
+    std::uint64_t children_offset;
+    std::uint64_t entries_offset;
+    std::uint64_t sorted_offset;
+    std::uint64_t strings_offset;  ///< string_count + 1 offsets into chars
+    std::uint64_t chars_offset;
+    std::uint64_t string_slots_offset;
+    std::uint64_t size;
+};
+
+enum config_flags : std::uint8_t {
+    CONFIG_INT = 1,     ///< int_value holds the scalar as a signed integer
+    CONFIG_UINT = 2,    ///< int_value holds the scalar as an unsigned integer
+    CONFIG_DOUBLE = 4,  ///< double_value holds the scalar
+    CONFIG_FLOAT = 8,   ///< float_value holds the scalar
+    CONFIG_BOOL = 16,   ///< int_value holds the scalar as 0 or 1
+};
+
+/**
+ * @brief A node of a config buffer.  Scalars store their string id in first and the conversions that succeeded in
+ * flags.  Sequences store a range of children and maps a range of entries, plus for large maps a range of sorted
+ * entry positions.
+ */
+struct config_node_data {
+    std::uint8_t type;  ///< YAML::NodeType::value
+    std::uint8_t flags;
+    std::uint16_t reserved;
+    std::uint32_t tag;  ///< String id
+    std::uint32_t first;
+    std::uint32_t size;
+    std::uint32_t sorted;
+    float float_value;
+    std::int32_t line;  ///< Position in the source YAML, -1 if unknown
+    std::int32_t column;
+    std::int64_t int_value;
+    double double_value;
+};
+
+struct config_entry_data {
+    std::uint32_t key;  ///< String id
+    std::uint32_t value;
+};
+
+/**
+ * @brief The sections of a config buffer, and ownership of it.
+ */
+struct config_sections {
+    std::shared_ptr<void const> storage;
+    config_header const* header = nullptr;
+    config_node_data const* nodes = nullptr;
+    std::uint32_t const* children = nullptr;
+    config_entry_data const* entries = nullptr;
+    std::uint32_t const* sorted = nullptr;
+    std::uint64_t const* strings = nullptr;
+    char const* chars = nullptr;
+    std::uint32_t const* string_slots = nullptr;  ///< Hash table of string id + 1, 0 is empty
+
+    std::string_view string(std::uint32_t id) const {
+        return {this->chars + this->strings[id], std::size_t(this->strings[id + 1] - this->strings[id])};
+    }
+
+    /**
+     * @brief Id of str, or npos if str isn't in the buffer.
+     */
+    std::uint32_t find_string(std::string_view str) const;
+
+    static constexpr std::uint32_t npos = std::uint32_t(-1);
+};
+
+/**
+ * @brief Finds the sections of the config buffer in storage, checking that every offset and index in it is in range.
+ * @throws std::runtime_error if the buffer isn't a valid config buffer
+ */
+std::shared_ptr<config_sections const> make_config_sections(std::shared_ptr<void const> storage, std::size_t size);
+
+}  // namespace details
+// \endcond
+
+/**
+ * @brief A map key of a config_node, exposing Scalar() like the key of a YAML map entry.
+ */
+struct config_key {
+    std::string_view Scalar() const { return this->value; }
+
+    std::string_view value;
+};
+
+struct config_entry;
+
+/**
+ * @brief Read-only view of a node in a config_document, with the parts of the YAML::Node interface yadi uses to
+ * create types.  Scalars that convert to an integer, floating point or bool were converted when the document was
+ * built, so as<T>() for those types is a range check.  Looking up a map key compares interned string ids instead of
+ * strings.  A view is only valid while the document it came from, or a copy of it, is alive.  A default constructed
+ * view is undefined, like the YAML::Node for a missing map key.
+ */
+class config_node {
+   public:
+    class iterator;
+
+    config_node() = default;
+
+    /**
+     * @brief A null node, what create passes an initializer when no config is given.
+     */
+    static config_node null();
+
+    YAML::NodeType::value Type() const;
+    bool IsDefined() const { return this->Type() != YAML::NodeType::Undefined; }
+    bool IsNull() const { return this->Type() == YAML::NodeType::Null; }
+    bool IsScalar() const { return this->Type() == YAML::NodeType::Scalar; }
+    bool IsSequence() const { return this->Type() == YAML::NodeType::Sequence; }
+    bool IsMap() const { return this->Type() == YAML::NodeType::Map; }
+    explicit operator bool() const { return this->IsDefined(); }
+
+    /**
+     * @brief Number of elements or entries, 0 for other nodes.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Scalar value, empty for other nodes.
+     */
+    std::string_view Scalar() const;
+
+    std::string_view Tag() const;
+
+    /**
+     * @brief Position of the node in the YAML the document was built from, used in conversion errors.
+     */
+    YAML::Mark Mark() const;
+
+    /**
+     * @brief Element index of a sequence.
+     * @return The element, undefined if this isn't a sequence or index is out of range
+     */
+    config_node operator[](std::size_t index) const;
+
+    /**
+     * @brief Value of key in a map.  If the key is repeated the first value is used, as with YAML::Node.
+     * @return The value, undefined if this isn't a map or key isn't in it
+     */
+    config_node operator[](std::string_view key) const;
+    config_node operator[](char const* key) const { return (*this)[std::string_view(key)]; }
+    config_node operator[](int index) const { return (*this)[std::size_t(index)]; }
+
+    /**
+     * @brief Converts the node to T.  Integer, floating point, bool and std::string use the values stored in the
+     * document, anything else converts to_yaml() with yaml-cpp.  Errors are the same as YAML::Node::as<T>(),
+     * including the position of the node.
+     * @tparam T
+     * @return
+     */
+    template <typename T>
+    T as() const;
+
+    /**
+     * @brief Builds a YAML::Node with the same content.
+     * @return
+     */
+    YAML::Node to_yaml() const;
+
+    iterator begin() const;
+    iterator end() const;
+
+   private:
+    friend class config_document;
+
+    config_node(details::config_sections const* sections, std::uint32_t index) : sections(sections), index(index) {}
+
+    details::config_node_data const& data() const { return this->sections->nodes[this->index]; }
+
+    template <typename T>
+    bool stored_as(T& out) const;
+
+    details::config_sections const* sections = nullptr;
+    std::uint32_t index = 0;
+};
+
+/**
+ * @brief What iterating a config_node yields.  For a sequence this is the element, for a map first and second are
+ * the key and value, the same as iterating a YAML::Node.
+ */
+struct config_entry : public config_node {
+    config_entry() = default;
+    explicit config_entry(config_node element) : config_node(element) {}
+    config_entry(config_key first, config_node second) : first(first), second(second) {}
+
+    config_key first;
+    config_node second;
+};
+
+class config_node::iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = config_entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = config_entry const*;
+    using reference = config_entry const&;
+
+    iterator() = default;
+
+    reference operator*() const { return this->current; }
+    pointer operator->() const { return &this->current; }
+
+    iterator& operator++() {
+        ++this->position;
+        this->load();
+        return *this;
+    }
+
+    iterator operator++(int) {
+        iterator const previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool operator==(iterator const& other) const { return this->position == other.position; }
+    bool operator!=(iterator const& other) const { return this->position != other.position; }
+
+   private:
+    friend class config_node;
+
+    iterator(config_node node, std::uint32_t position) : node(node), position(position) { this->load(); }
+
+    void load();
+
+    config_node node;
+    std::uint32_t position = 0;
+    config_entry current;
+};
+
+/**
+ * @brief A YAML config parsed once into a single contiguous buffer.  Map keys and scalars are interned, the children
+ * of a node are stored next to each other and scalars are converted to integer, floating point and bool when the
+ * document is built, so creating types from it doesn't walk YAML::Node trees or parse numbers again.  from_yaml,
+ * create and the initializers made by make_*_initializer accept its nodes, see config_node.  Copies share the buffer.
+ *
+ * The buffer only holds offsets, so it can be saved and used again without parsing by mapping the file, see
+ * map_file.  The yadi_compile tool writes these files from YAML.
+ */
+class config_document {
+   public:
+    /**
+     * @brief An empty document, its root is undefined.
+     */
+    config_document() = default;
+
+    /**
+     * @brief Builds the document from yaml.
+     * @param yaml
+     * @throws std::runtime_error if a map key isn't a scalar
+     */
+    explicit config_document(YAML::Node const& yaml);
+
+    /**
+     * @brief Parses yaml and builds the document from it.
+     * @param yaml
+     * @return
+     */
+    static config_document load(std::string const& yaml);
+
+    /**
+     * @brief Uses a buffer written by save in place.  The buffer must be 8 byte aligned and is checked before use.
+     * @param buffer Kept alive by the document and its copies
+     * @param size Size of the buffer in bytes
+     * @return
+     * @throws std::runtime_error if buffer isn't a valid document
+     */
+    static config_document from_buffer(std::shared_ptr<void const> buffer, std::size_t size);
+
+    /**
+     * @brief Maps a file written by save into memory and uses it in place, nothing is parsed or copied.  The file
+     * is unmapped once the document and its copies are destroyed.  Where memory mapping isn't available the file is
+     * read instead.
+     * @param path
+     * @return
+     * @throws std::runtime_error if the file can't be read or isn't a valid document
+     */
+    static config_document map_file(std::string const& path);
+
+    /**
+     * @brief Writes the buffer holding the document.  Can be read back by map_file or from_buffer on a machine with
+     * the same byte order.
+     * @param out
+     */
+    void save(std::ostream& out) const;
+
+    config_node root() const;
+
+    /**
+     * @brief The buffer holding the document.
+     */
+    void const* data() const;
+
+    /**
+     * @brief Size in bytes of the buffer holding the document.
+     */
+    std::size_t size() const;
+
+   private:
+    std::shared_ptr<details::config_sections const> sections;
+};
+
+// ############################ IMPL ############################
+
+template <typename T>
+bool config_node::stored_as(T& out) const {
+    if (!this->IsScalar()) {
+        return false;
+    }
+    details::config_node_data const& node = this->data();
+
+    if constexpr (std::is_same<T, bool>::value) {
+        if (node.flags & details::CONFIG_BOOL) {
+            out = node.int_value != 0;
+            return true;
+        }
+    } else if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                         std::is_same<T, unsigned char>::value || std::is_same<T, wchar_t>::value ||
+                         std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value) {
+        // yaml-cpp converts these as characters or with its own checks
+        return false;
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        if ((node.flags & details::CONFIG_INT) && node.int_value >= std::numeric_limits<T>::min() &&
+            node.int_value <= std::numeric_limits<T>::max()) {
+            out = static_cast<T>(node.int_value);
+            return true;
+        }
+    } else if constexpr (std::is_integral<T>::value) {
+        std::uint64_t const value = static_cast<std::uint64_t>(node.int_value);
+        if ((node.flags & details::CONFIG_UINT) && value <= std::numeric_limits<T>::max()) {
+            out = static_cast<T>(value);
+            return true;
+        }
+    } else if constexpr (std::is_same<T, double>::value) {
+        if (node.flags & details::CONFIG_DOUBLE) {
+            out = node.double_value;
+            return true;
+        }
+    } else if constexpr (std::is_same<T, float>::value) {
+        if (node.flags & details::CONFIG_FLOAT) {
+            out = node.float_value;
+            return true;
+        }
+    } else if constexpr (std::is_same<T, std::string>::value) {
+        out.assign(this->Scalar());
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+T config_node::as() const {
+    if constexpr (std::is_same<T, config_node>::value) {
+        return *this;
+    } else if constexpr (std::is_same<T, YAML::Node>::value) {
+        return this->to_yaml();
+    } else {
+        if constexpr (std::is_arithmetic<T>::value || std::is_same<T, std::string>::value) {
+            T value;
+            if (this->stored_as(value)) {
+                return value;
+            }
+        }
+        try {
+            return this->to_yaml().as<T>();
+        } catch (YAML::BadConversion const&) {
+            // The converted node doesn't know where it came from
+            throw YAML::TypedBadConversion<T>(this->Mark());
+        }
+    }
+}
+
+}  // namespace yadi
+
+namespace YAML {
+
+/**
+ * @brief Lets a config_node be passed where a YAML::Node is expected, by converting it with to_yaml().  This is how
+ * adapters and initializers without a config_node overload are reached.
+ */
+template <>
+struct convert<::yadi::config_node> {
+    static Node encode(::yadi::config_node const& config) { return config.to_yaml(); }
+};
+
+}  // namespace YAML
+
+#endif  // YADI_CONFIG_IR_HPP
@@ -0,0 +1,64 @@
+#include "create_result.hpp"
+
+#include <stdexcept>
+
+namespace yadi {
+
+namespace {
+
+std::string cause_message(std::exception_ptr const& cause) {
+    try {
+        std::rethrow_exception(cause);
+    } catch (std::exception const& ex) {
+        return ex.what();
+    } catch (...) {
+        return "Unknown exception";
+    }
+}
+
+}  // anonymous namespace
+
+create_error& create_error::within(std::string_view segment) {
+    std::string path(segment);
+    if (!this->config_path.empty()) {
+        if (this->config_path.front() != '[') {
+            path += '.';
+        }
+        path += this->config_path;
+    }
+    this->config_path = std::move(path);
+    return *this;
+}
+
+std::string create_error::message() const {
+    switch (this->error) {
+        case error_code::type_not_found:
+            return "\"" + this->type_name + "\" not found in \"" + std::string(this->factory_name) + "\" factory";
+        case error_code::initializer_failed:
+            return "Error creating \"" + this->type_name + "\": " + cause_message(this->error_cause);
+        case error_code::adapter_failed:
+            return cause_message(this->error_cause);
+        case error_code::config_not_defined:
+            return "Factory config not defined";
+        case error_code::configs_not_defined:
+            return "From YAML factory configs not defined";
+        case error_code::scalar_not_valid:
+            return "Factory config scalar not valid";
+        case error_code::type_not_defined:
+            return "Factory config type not defined";
+        case error_code::type_not_valid:
+            return "Factory config type not valid";
+        case error_code::config_not_valid:
+            return "Factory config not valid, YAML must be scalar string or map";
+    }
+    return "Unknown error";
+}
+
+void create_error::raise() const {
+    if (this->error == error_code::adapter_failed && this->error_cause) {
+        std::rethrow_exception(this->error_cause);
+    }
+    throw std::runtime_error(this->message());
+}
+
+}  // namespace yadi
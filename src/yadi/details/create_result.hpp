@@ -0,0 +1,156 @@
+#ifndef YADI_CREATE_RESULT_HPP
+#define YADI_CREATE_RESULT_HPP
+
+#include <exception>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Why a try_create, try_from_yaml or try_from_yamls failed.
+ */
+enum class error_code {
+    type_not_found,       ///< No initializer is registered for the type
+    initializer_failed,   ///< The initializer threw, see create_error::cause
+    adapter_failed,       ///< An adapter without try_create threw, see create_error::cause
+    config_not_defined,   ///< The factory config is missing
+    configs_not_defined,  ///< The sequence of factory configs is missing
+    scalar_not_valid,     ///< The factory config is an empty scalar
+    type_not_defined,     ///< The factory config map has no type
+    type_not_valid,       ///< The factory config type isn't a non empty scalar
+    config_not_valid,     ///< The factory config is neither a scalar nor a map
+};
+
+/**
+ * @brief Failure of a non throwing create.  Holds what went wrong rather than a message, which message formats on
+ * demand with the same text the throwing API uses.
+ */
+class create_error {
+   public:
+    /**
+     * @param code
+     * @param type The type being created, if known
+     * @param factory Name of the factory's base type, must outlive the error, such as demangle_type<BT>()
+     * @param cause The exception thrown for initializer_failed and adapter_failed
+     */
+    explicit create_error(error_code code, std::string type = {}, std::string_view factory = {},
+                          std::exception_ptr cause = {})
+        : error(code), type_name(std::move(type)), factory_name(factory), error_cause(std::move(cause)) {}
+
+    error_code code() const { return this->error; }
+
+    std::string const& type() const { return this->type_name; }
+
+    std::string_view factory() const { return this->factory_name; }
+
+    /**
+     * @brief Where in the factory configs the error is, such as "[2].config".  Empty for the config passed in.
+     */
+    std::string const& path() const { return this->config_path; }
+
+    std::exception_ptr const& cause() const { return this->error_cause; }
+
+    /**
+     * @brief Prepends a key, or an index written as "[i]", to path.
+     * @param segment
+     * @return *this
+     */
+    create_error& within(std::string_view segment);
+
+    /**
+     * @brief The message the throwing API reports for this error.
+     */
+    std::string message() const;
+
+    /**
+     * @brief Throws what the throwing API would, a std::runtime_error with message() or, for adapter_failed, the
+     * adapter's exception.
+     */
+    [[noreturn]] void raise() const;
+
+   private:
+    error_code error;
+    std::string type_name;
+    std::string_view factory_name;
+    std::string config_path;
+    std::exception_ptr error_cause;
+};
+
+/**
+ * @brief Either a value or the create_error explaining why there is none, returned by the non throwing API.
+ * @tparam T The value type
+ */
+template <typename T>
+class create_result {
+   public:
+    using value_type = T;
+
+    create_result(T value) : state(std::in_place_index<0>, std::move(value)) {}
+
+    create_result(create_error error) : state(std::in_place_index<1>, std::move(error)) {}
+
+    bool has_value() const noexcept { return this->state.index() == 0; }
+
+    explicit operator bool() const noexcept { return this->has_value(); }
+
+    /**
+     * @throws What create_error::raise throws if there is no value
+     */
+    T& value() & {
+        this->check();
+        return *std::get_if<0>(&this->state);
+    }
+
+    T const& value() const& {
+        this->check();
+        return *std::get_if<0>(&this->state);
+    }
+
+    T&& value() && {
+        this->check();
+        return std::move(*std::get_if<0>(&this->state));
+    }
+
+    template <typename U>
+    T value_or(U&& fallback) && {
+        return this->has_value() ? std::move(*std::get_if<0>(&this->state)) : T(std::forward<U>(fallback));
+    }
+
+    /**
+     * @brief The error, only valid if there is no value.
+     */
+    create_error const& error() const& { return *std::get_if<1>(&this->state); }
+
+    create_error&& error() && { return std::move(*std::get_if<1>(&this->state)); }
+
+    T& operator*() & { return *std::get_if<0>(&this->state); }
+
+    T const& operator*() const& { return *std::get_if<0>(&this->state); }
+
+    T&& operator*() && { return std::move(*std::get_if<0>(&this->state)); }
+
+    T* operator->() { return std::get_if<0>(&this->state); }
+
+    T const* operator->() const { return std::get_if<0>(&this->state); }
+
+   private:
+    void check() const {
+        if (!this->has_value()) {
+            std::get_if<1>(&this->state)->raise();
+        }
+    }
+
+    std::variant<T, create_error> state;
+};
+
+}  // namespace yadi
+
+#endif  // YADI_CREATE_RESULT_HPP
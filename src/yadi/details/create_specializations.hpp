@@ -7,11 +7,21 @@
 
 #include "create_utils.hpp"
 #include "factory.hpp"
+#include "flat_containers.hpp"
+#include "scalar_parse.hpp"
 
+#include <array>
+#include <cstddef>
+#include <deque>
 #include <iterator>
 #include <list>
 #include <map>
 #include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -37,6 +47,115 @@ struct passthrough {
 };
 
 namespace details {
+template <typename CT, typename = void>
+struct has_reserve : std::false_type {};
+
+template <typename CT>
+struct has_reserve<CT, std::void_t<decltype(std::declval<CT&>().reserve(std::size_t()))>> : std::true_type {};
+
+/**
+ * @brief Reserves room in out for every entry of config if out can reserve, so it's sized once up front.
+ */
+template <typename CT, typename NT>
+void reserve_for(CT& out, NT const& config) {
+    if constexpr (has_reserve<CT>::value) {
+        if (config.IsSequence() || config.IsMap()) {
+            out.reserve(config.size());
+        }
+    }
+}
+
+/**
+ * @brief Converts a sequence of numbers straight into out, rather than creating each element through its factory.
+ * Like direct_scalar it steps aside when creates are instrumented or traced, so each element is counted and traced.
+ * @tparam T Element type
+ * @return False if T isn't a number created by value, the initializer of T isn't stock_by_value, creates are
+ * instrumented or traced, or an element didn't convert.  Out may have been partly written.
+ */
+template <typename T, typename NT, typename OI>
+bool read_numbers(NT const& config, OI out) {
+    if constexpr (std::is_arithmetic<T>::value && meta::is_by_value<T>::value && !instrumented) {
+        if (!config.IsSequence() || details::active_trace_sink() || !stock_by_value<T, NT>()) {
+            return false;
+        }
+        try {
+            for (auto const &entry : config) {
+                T value{};
+                // A config_node already holds the number
+                if constexpr (std::is_same<NT, config_node>::value) {
+                    value = entry.template as<T>();
+                } else if (!entry.IsScalar() || !parse_scalar(entry.Scalar(), value)) {
+                    value = entry.template as<T>();
+                }
+                *out = value;
+                ++out;
+            }
+        } catch (std::exception const&) {
+            // Left to from_yamls, which reports where the error is
+            return false;
+        }
+        return true;
+    } else {
+        return false;
+    }
+}
+
+/**
+ * @brief Appends every element of config to out, sized once up front.
+ */
+template <typename ET, typename LT, typename NT>
+void read_sequence(NT const& config, LT& out) {
+    reserve_for(out, config);
+    if (!read_numbers<ET>(config, std::back_inserter(out))) {
+        out.clear();
+        from_yamls<ET>(config, std::back_inserter(out));
+    }
+}
+
+/**
+ * @brief Converts a map key to K.  Number and enum keys are parsed in place where parse_scalar can, other keys that
+ * can't be constructed from the string, including characters, are converted by yaml-cpp.
+ * @tparam K
+ * @param scalar
+ * @return
+ */
+template <typename K>
+K map_key(std::string_view scalar) {
+    if constexpr (std::is_constructible<K, std::string_view>::value) {
+        return K(scalar);
+    } else if constexpr (std::is_enum<K>::value) {
+        return static_cast<K>(map_key<std::underlying_type_t<K>>(scalar));
+    } else {
+        if constexpr (is_parsed_scalar<K>::value) {
+            K key{};
+            if (parse_scalar(scalar, key)) {
+                return key;
+            }
+        }
+        // Hex, octal and anything else yaml-cpp accepts, or its conversion error
+        return YAML::Node(std::string(scalar)).as<K>();
+    }
+}
+
+/**
+ * @brief The scalar of a map key.  A key that isn't a scalar fails to convert, as it does converting the map with
+ * yaml-cpp, rather than reading as an empty string.
+ * @param key
+ * @return
+ * @throws YAML::TypedBadConversion<std::string> if key isn't a scalar
+ */
+inline std::string_view key_scalar(YAML::Node const &key) {
+    if (!key.IsScalar()) {
+        throw YAML::TypedBadConversion<std::string>(key.Mark());
+    }
+    return key.Scalar();
+}
+
+/**
+ * @brief The scalar of a map key, a config_document only holds scalar keys.
+ */
+inline std::string_view key_scalar(config_key const &key) { return key.Scalar(); }
+
 template<typename LT>
 struct back_inserter_adapter {
     using element_type = typename LT::value_type;
@@ -44,15 +163,21 @@ struct back_inserter_adapter {
     using output_type = LT;
     static constexpr bool direct_from_yaml = true;
 
-    static output_type create(std::string const &, YAML::Node const &config = {}) {
+    static output_type create(std::string_view, YAML::Node const &config = {}) {
+        output_type out;
+        read_sequence<element_type>(config, out);
+        return out;
+    }
+
+    static output_type create(std::string_view, config_node const &config) {
         output_type out;
-        from_yamls<element_type>(config, std::back_inserter(out));
+        read_sequence<element_type>(config, out);
         return out;
     }
 
-    static std::string get_name() {
-        using namespace std::string_literals;
-        return "list<"s + adapter<element_type>::get_name() + ">";
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get([] { return "list<" + std::string(adapter<element_type>::get_name()) + ">"; });
     }
 };
 
@@ -63,15 +188,29 @@ struct inserter_adapter {
     using output_type = ST;
     static constexpr bool direct_from_yaml = true;
 
-    static output_type create(std::string const &, YAML::Node const &config = {}) {
+    static output_type create(std::string_view, YAML::Node const &config = {}) {
+        output_type out;
+        reserve_for(out, config);
+        if (!read_numbers<element_type>(config, std::inserter(out, out.end()))) {
+            out.clear();
+            from_yamls<element_type>(config, std::inserter(out, out.end()));
+        }
+        return out;
+    }
+
+    static output_type create(std::string_view, config_node const &config) {
         output_type out;
-        from_yamls<element_type>(config, std::inserter(out, out.end()));
+        reserve_for(out, config);
+        if (!read_numbers<element_type>(config, std::inserter(out, out.end()))) {
+            out.clear();
+            from_yamls<element_type>(config, std::inserter(out, out.end()));
+        }
         return out;
     }
 
-    static std::string get_name() {
-        using namespace std::string_literals;
-        return "set<"s + adapter<element_type>::get_name() + ">";
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get([] { return "set<" + std::string(adapter<element_type>::get_name()) + ">"; });
     }
 };
 
@@ -80,29 +219,134 @@ struct map_adapter {
     using output_type = MT;
     static constexpr bool direct_from_yaml = true;
 
-    static output_type create(std::string const &, YAML::Node const &config = {}) {
-        using key_type = typename MT::key_type;
-        using mapped_type = typename MT::mapped_type;
+    static output_type create(std::string_view, YAML::Node const &config = {}) {
+        if (!config.IsMap()) {
+            throw std::runtime_error("Must create map from map");
+        }
+        return from_entries(config);
+    }
 
+    static output_type create(std::string_view, config_node const &config) {
         if (!config.IsMap()) {
             throw std::runtime_error("Must create map from map");
         }
+        return from_entries(config);
+    }
+
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get([] { return "map<" + std::string(::yadi::demangle_type<typename MT::value_type>()) + ">"; });
+    }
 
+   private:
+    // Entries are read in place and created in document order.  Repeated keys keep the last value, as converting YAML
+    // to std::map does.  Hinting the end makes sorted keys a constant time insert into a std::map.
+    template <typename NT>
+    static output_type from_entries(NT const &config) {
         output_type out;
-        std::map<std::string, YAML::Node> yamlMap = config.as<std::map<std::string, YAML::Node>>();
-        for (auto const &entry : yamlMap) {
-            key_type key = entry.first;
-            mapped_type value = ::yadi::from_yaml<mapped_type>(entry.second);
-            if (!out.insert(std::make_pair(std::move(key), std::move(value))).second) {
-                throw std::runtime_error("Map must contiain unique keys");
-            }
+        reserve_for(out, config);
+        for (auto const &entry : config) {
+            out.insert_or_assign(out.end(), map_key<typename MT::key_type>(key_scalar(entry.first)),
+                                 ::yadi::from_yaml<typename MT::mapped_type>(entry.second));
         }
         return out;
     }
+};
+
+template <typename AT>
+struct array_adapter {
+    using element_type = typename AT::value_type;
+    using base_type = meta::derive_base_type_t<element_type>;
+    using output_type = AT;
+    static constexpr bool direct_from_yaml = true;
+    static constexpr std::size_t size = std::tuple_size<AT>::value;
+
+    static output_type create(std::string_view, YAML::Node const &config = {}) { return from_sequence(config); }
+
+    static output_type create(std::string_view, config_node const &config) { return from_sequence(config); }
+
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get([] {
+            return "array<" + std::string(adapter<element_type>::get_name()) + ", " + std::to_string(size) + ">";
+        });
+    }
+
+   private:
+    template <typename NT>
+    static output_type from_sequence(NT const &config) {
+        if (!config.IsSequence() || config.size() != size) {
+            throw std::runtime_error("Must create array from sequence of " + std::to_string(size));
+        }
+        output_type out{};
+        if (!read_numbers<element_type>(config, out.begin())) {
+            from_yamls<element_type>(config, out.begin());
+        }
+        return out;
+    }
+};
+
+template <typename ST>
+struct flat_set_adapter {
+    using element_type = typename ST::value_type;
+    using base_type = meta::derive_base_type_t<element_type>;
+    using output_type = ST;
+    static constexpr bool direct_from_yaml = true;
+
+    static output_type create(std::string_view, YAML::Node const &config = {}) {
+        typename ST::container_type values;
+        read_sequence<element_type>(config, values);
+        return output_type(std::move(values));
+    }
+
+    static output_type create(std::string_view, config_node const &config) {
+        typename ST::container_type values;
+        read_sequence<element_type>(config, values);
+        return output_type(std::move(values));
+    }
 
-    static std::string get_name() {
-        using namespace std::string_literals;
-        return "map<"s + ::yadi::demangle_type<typename MT::value_type>() + ">";
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get([] { return "flat_set<" + std::string(adapter<element_type>::get_name()) + ">"; });
+    }
+};
+
+template <typename MT>
+struct flat_map_adapter {
+    using output_type = MT;
+    static constexpr bool direct_from_yaml = true;
+
+    static output_type create(std::string_view, YAML::Node const &config = {}) {
+        if (!config.IsMap()) {
+            throw std::runtime_error("Must create map from map");
+        }
+        return from_entries(config);
+    }
+
+    static output_type create(std::string_view, config_node const &config) {
+        if (!config.IsMap()) {
+            throw std::runtime_error("Must create map from map");
+        }
+        return from_entries(config);
+    }
+
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get(
+            [] { return "flat_map<" + std::string(::yadi::demangle_type<typename MT::value_type>()) + ">"; });
+    }
+
+   private:
+    // Entries are created in document order into one vector, which the flat_map sorts once
+    template <typename NT>
+    static output_type from_entries(NT const &config) {
+        typename MT::container_type entries;
+        entries.reserve(config.size());
+        for (auto const &entry : config) {
+            entries.emplace_back(map_key<typename MT::key_type>(key_scalar(entry.first)),
+                                 ::yadi::from_yaml<typename MT::mapped_type>(entry.second));
+        }
+        return output_type(std::move(entries));
     }
 };
 
@@ -113,14 +357,19 @@ struct optional_adapter {
     using output_type = OT;
     static constexpr bool direct_from_yaml = ::yadi::adapter<element_type>::direct_from_yaml;
 
-    static output_type create(std::string const &type, YAML::Node const &config = {}) {
+    static output_type create(std::string_view type, YAML::Node const &config = {}) {
+        output_type out = ::yadi::create<element_type>(type, config);
+        return out;
+    }
+
+    static output_type create(std::string_view type, config_node const &config) {
         output_type out = ::yadi::create<element_type>(type, config);
         return out;
     }
 
-    static std::string get_name() {
-        using namespace std::string_literals;
-        return "optional<"s + adapter<element_type>::get_name() + ">";
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get([] { return "optional<" + std::string(adapter<element_type>::get_name()) + ">"; });
     }
 };
 
@@ -132,15 +381,22 @@ struct passthrough_adapter {
     using final_output_type = typename PT::output_type;
     static constexpr bool direct_from_yaml = ::yadi::adapter<base_type>::direct_from_yaml;
 
-    static output_type create(std::string const &type, YAML::Node const &config = {}) {
+    static output_type create(std::string_view type, YAML::Node const &config = {}) {
         output_type out(::yadi::create<element_type>(type, config));
         return out;
     }
 
-    static std::string get_name() {
-        using namespace std::string_literals;
-        return "passthrough<"s + adapter<final_output_type>::get_name() + ", " + adapter<element_type>::get_name() +
-               ">";
+    static output_type create(std::string_view type, config_node const &config) {
+        output_type out(::yadi::create<element_type>(type, config));
+        return out;
+    }
+
+    static std::string_view get_name() {
+        static name_cache cache;
+        return cache.get([] {
+            return "passthrough<" + std::string(adapter<final_output_type>::get_name()) + ", " +
+                   std::string(adapter<element_type>::get_name()) + ">";
+        });
     }
 };
 } // namespace details
@@ -151,29 +407,47 @@ struct adapter<std::list<ET>> : public details::back_inserter_adapter<std::list<
 template <typename ET>
 struct adapter<std::vector<ET>> : public details::back_inserter_adapter<std::vector<ET>> {};
 
+template <typename ET>
+struct adapter<std::deque<ET>> : public details::back_inserter_adapter<std::deque<ET>> {};
+
+template <typename ET, std::size_t N>
+struct adapter<std::array<ET, N>> : public details::array_adapter<std::array<ET, N>> {};
+
 template <typename ET>
 struct adapter<std::set<ET>> : public details::inserter_adapter<std::set<ET>> {};
 
 template <typename ET>
-struct adapter<std::optional<ET>> : public details::optional_adapter<std::optional<ET>> {};
+struct adapter<flat_set<ET>> : public details::flat_set_adapter<flat_set<ET>> {};
 
 template <typename ET>
-struct factory_traits<std::map<std::string, ET>> {
-    using ptr_type = std::map<std::string, ET>;
+struct adapter<std::optional<ET>> : public details::optional_adapter<std::optional<ET>> {};
+
+template <typename KT, typename ET>
+struct factory_traits<std::map<KT, ET>> {
+    using ptr_type = std::map<KT, ET>;
     static const bool direct_from_yaml = true;
 };
 
-template <typename ET>
-struct adapter<std::map<std::string, ET>> : public details::map_adapter<std::map<std::string, ET>> {};
+template <typename KT, typename ET>
+struct adapter<std::map<KT, ET>> : public details::map_adapter<std::map<KT, ET>> {};
 
-template <typename ET>
-struct factory_traits<std::unordered_map<std::string, ET>> {
-    using ptr_type = std::unordered_map<std::string, ET>;
+template <typename KT, typename ET>
+struct factory_traits<std::unordered_map<KT, ET>> {
+    using ptr_type = std::unordered_map<KT, ET>;
     static const bool direct_from_yaml = true;
 };
 
-template <typename ET>
-struct adapter<std::unordered_map<std::string, ET>> : public details::map_adapter<std::unordered_map<std::string, ET>> {};
+template <typename KT, typename ET>
+struct adapter<std::unordered_map<KT, ET>> : public details::map_adapter<std::unordered_map<KT, ET>> {};
+
+template <typename KT, typename ET>
+struct factory_traits<flat_map<KT, ET>> {
+    using ptr_type = flat_map<KT, ET>;
+    static const bool direct_from_yaml = true;
+};
+
+template <typename KT, typename ET>
+struct adapter<flat_map<KT, ET>> : public details::flat_map_adapter<flat_map<KT, ET>> {};
 
 template <typename OT, typename BT>
 struct adapter<passthrough<OT, BT>> : public details::passthrough_adapter<passthrough<OT, BT>> { };
@@ -7,10 +7,22 @@
 
 #include "factory.hpp"
 #include "help.hpp"
+#include "create_result.hpp"
+#include "scalar_parse.hpp"
+#include "trace.hpp"
 #include "type_utils.hpp"
 
 #include <yaml-cpp/yaml.h>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
 /**
  * @namespace yadi
  * @brief YADI
@@ -48,13 +60,172 @@ struct adapter {
      * @param config
      * @return
      */
-    static output_type create(std::string const& type, YAML::Node const& config = {}) {
+    static output_type create(std::string_view type, YAML::Node const& config = {}) {
         return factory<base_type>::create(type, config);
     }
 
-    static std::string get_name() { return yadi_help::get_name<base_type>(); }
+    /**
+     * @brief The default is to forward to factory<base_type>::create(type, config);
+     * @param type
+     * @param config
+     * @return
+     */
+    static output_type create(std::string_view type, config_node const& config) {
+        return factory<base_type>::create(type, config);
+    }
+
+    /**
+     * @brief Optional for adapters, used by try_create and try_from_yaml.  Adapters without it are called through
+     * create and exceptions it throws are returned as adapter_failed errors.
+     * @param type
+     * @param config
+     * @return
+     */
+    static create_result<output_type> try_create(std::string_view type, YAML::Node const& config = {}) {
+        return factory<base_type>::try_create(type, config);
+    }
+
+    static create_result<output_type> try_create(std::string_view type, config_node const& config) {
+        return factory<base_type>::try_create(type, config);
+    }
+
+    static std::string_view get_name() { return yadi_help::get_name<base_type>(); }
 };
 
+// Declared in initializers.hpp, which includes this
+template <typename T>
+T yaml_as(YAML::Node const& config);
+
+template <typename T>
+T config_as(config_node const& config);
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief Whether T is still created by the yaml_as initializer registered for it by value, so converting a config
+ * straight to T skips nothing registered for T, such as another initializer or a registration_mod.  Checked again
+ * only when the factory of T changes.
+ * @tparam T
+ * @tparam NT YAML::Node or config_node, whose initializer is checked
+ */
+template <typename T, typename NT>
+bool stock_by_value() {
+    // Generation plus one, shifted left, with the answer in the low bit
+    static std::atomic<std::uint64_t> checked{0};
+    std::uint64_t const generation = factory<T>::generation() + 1;
+    std::uint64_t const cached = checked.load(std::memory_order_acquire);
+    if (cached >> 1 == generation) {
+        return cached & 1;
+    }
+
+    bool stock = false;
+    if (auto const* yadis = factory<T>::find(type_by_value_key())) {
+        auto const& resolved = yadis->lazy ? yadis->lazy->get() : *yadis;
+        if constexpr (std::is_same<NT, config_node>::value) {
+            auto const* initializer = resolved.config_initializer.template target<T (*)(config_node const&)>();
+            stock = initializer && *initializer == &config_as<T>;
+        } else {
+            auto const* initializer = resolved.initializer.template target<T (*)(YAML::Node const&)>();
+            stock = initializer && *initializer == &yaml_as<T>;
+        }
+    }
+    checked.store(generation << 1 | (stock ? 1 : 0), std::memory_order_release);
+    return stock;
+}
+
+/**
+ * @brief Whether from_yaml<OT> may convert a scalar config itself instead of calling the factory, see stock_by_value.
+ * Types with a registration_mod always go through the factory, and so does everything when creates are instrumented.
+ */
+template <typename OT>
+struct direct_scalar
+    : std::integral_constant<bool, std::is_same<OT, meta::derive_base_type_t<OT>>::value &&
+                                       meta::is_by_value<OT>::value && is_parsed_scalar<OT>::value &&
+                                       is_default_registration_mod<OT>::value && !instrumented> {};
+
+template <typename AT, typename CT, typename = void>
+struct has_try_create : std::false_type {};
+
+template <typename AT, typename CT>
+struct has_try_create<AT, CT, std::void_t<decltype(AT::try_create(std::string_view(), std::declval<CT const&>()))>>
+    : std::true_type {};
+
+template <typename AT, typename CT>
+create_result<typename AT::output_type> try_adapter_create(std::string_view type, CT const& config) {
+    if constexpr (has_try_create<AT, CT>::value) {
+        return AT::try_create(type, config);
+    } else {
+        // Adapters with try_create are traced by what they call, others get a span of their own
+        decltype(AT::get_name()) name{};
+        trace_span span;
+        if (trace_sink* sink = active_trace_sink()) {
+            name = AT::get_name();
+            span.begin(sink, trace_kind::adapter, name, type);
+        }
+        try {
+            return AT::create(type, config);
+        } catch (std::exception const&) {
+            return create_error(error_code::adapter_failed, std::string(type), {}, std::current_exception());
+        }
+    }
+}
+
+/**
+ * @brief Begins the span of a from_yaml call, named after the type the config gives if it gives one.
+ */
+template <typename OT>
+void begin_from_yaml_span(trace_span& span, trace_sink* sink, YAML::Node const& config) {
+    std::string_view type;
+    if (adapter<OT>::direct_from_yaml) {
+        type = type_by_value_key();
+    } else if (config.IsScalar()) {
+        type = config.Scalar();
+    } else if (config.IsMap()) {
+        YAML::Node const typeNode = config["type"];
+        if (typeNode.IsScalar()) {
+            type = typeNode.Scalar();
+        }
+    }
+    YAML::Mark const mark = config.IsDefined() ? config.Mark() : YAML::Mark::null_mark();
+    span.begin(sink, trace_kind::from_yaml, demangle_type<meta::derive_base_type_t<OT>>(), type, mark.line,
+               mark.column);
+}
+
+/**
+ * @brief See begin_from_yaml_span(trace_span&, trace_sink*, YAML::Node const&).  config_node has no source position.
+ */
+template <typename OT>
+void begin_from_yaml_span(trace_span& span, trace_sink* sink, config_node const& config) {
+    std::string_view type;
+    if (adapter<OT>::direct_from_yaml) {
+        type = type_by_value_key();
+    } else if (config.IsScalar()) {
+        type = config.Scalar();
+    } else if (config.IsMap() && config["type"].IsScalar()) {
+        type = config["type"].Scalar();
+    }
+    span.begin(sink, trace_kind::from_yaml, demangle_type<meta::derive_base_type_t<OT>>(), type);
+}
+
+/**
+ * @brief Converts a created value to OT, or passes the error on with segment prepended to its path.
+ */
+template <typename OT, typename T>
+create_result<OT> to_output(create_result<T>&& created, std::string_view segment = {}) {
+    if (!created) {
+        create_error error = std::move(created).error();
+        if (!segment.empty()) {
+            error.within(segment);
+        }
+        return error;
+    }
+    return OT(std::move(*created));
+}
+
+}  // namespace details
+// \endcond
+
 /**
  * @brief Same as adapter<FT>::create(type, config);
  * @tparam FT Type used to derive factory
@@ -63,7 +234,34 @@ struct adapter {
  * @return
  */
 template <typename FT>
-typename adapter<FT>::output_type create(std::string const& type, YAML::Node const& config = {});
+typename adapter<FT>::output_type create(std::string_view type, YAML::Node const& config = {});
+
+/**
+ * @brief Same as adapter<FT>::create(type, config).  Adapters without a config_node overload are passed the config
+ * converted to YAML.
+ * @tparam FT Type used to derive factory
+ * @param type
+ * @param config
+ * @return
+ */
+template <typename FT>
+typename adapter<FT>::output_type create(std::string_view type, config_node const& config);
+
+/**
+ * @brief Same as create(type, config) but returns failures rather than throwing them, see factory<BT>::try_create.
+ * @tparam FT Type used to derive factory
+ * @param type
+ * @param config
+ * @return The created instance or the error
+ */
+template <typename FT>
+create_result<typename adapter<FT>::output_type> try_create(std::string_view type, YAML::Node const& config = {});
+
+/**
+ * @brief See try_create(std::string_view, YAML::Node const&).
+ */
+template <typename FT>
+create_result<typename adapter<FT>::output_type> try_create(std::string_view type, config_node const& config);
 
 /**
  * @brief Pulls type and config from YAML.  This function is especially usefil when loading
@@ -79,6 +277,33 @@ typename adapter<FT>::output_type create(std::string const& type, YAML::Node con
 template <typename OT>
 OT from_yaml(YAML::Node const& factory_config);
 
+/**
+ * @brief See from_yaml(YAML::Node const&).  Reads the factory config from a config_document, which initializers
+ * registered with a config_initializer use without converting it to YAML.
+ * @tparam OT The desired output type.
+ * @param factory_config
+ * @return
+ */
+template <typename OT>
+OT from_yaml(config_node const& factory_config);
+
+/**
+ * @brief Same as from_yaml(factory_config) but returns failures rather than throwing them.  Malformed factory configs
+ * and unknown types don't throw at all.  The error's path is relative to factory_config, "type" for an unknown type
+ * and "config" for an initializer that failed.
+ * @tparam OT The desired output type.
+ * @param factory_config
+ * @return The created instance or the error
+ */
+template <typename OT>
+create_result<OT> try_from_yaml(YAML::Node const& factory_config);
+
+/**
+ * @brief See try_from_yaml(YAML::Node const&).
+ */
+template <typename OT>
+create_result<OT> try_from_yaml(config_node const& factory_config);
+
 /**
  * @brief Equivalent to from_yaml<ptr_type_t<base_type>>(config)
  * @tparam BT The factory baes type
@@ -100,6 +325,34 @@ ptr_type_t<BT> from_yaml_base(YAML::Node const& config = {}) {
 template <typename OT, typename OI>
 void from_yamls(YAML::Node const& factory_configs, OI out);
 
+/**
+ * @brief See from_yamls(YAML::Node const&, OI).
+ * @tparam OT
+ * @tparam OI Output iterator
+ * @param factory_configs
+ * @param out
+ */
+template <typename OT, typename OI>
+void from_yamls(config_node const& factory_configs, OI out);
+
+/**
+ * @brief Same as from_yamls(factory_configs, out) but returns the first failure rather than throwing it.  Elements
+ * before the failure are already written to out.  The error's path starts with the index of the failed element.
+ * @tparam OT
+ * @tparam OI Output iterator
+ * @param factory_configs
+ * @param out
+ * @return The number of elements written or the error
+ */
+template <typename OT, typename OI>
+create_result<std::size_t> try_from_yamls(YAML::Node const& factory_configs, OI out);
+
+/**
+ * @brief See try_from_yamls(YAML::Node const&, OI).
+ */
+template <typename OT, typename OI>
+create_result<std::size_t> try_from_yamls(config_node const& factory_configs, OI out);
+
 /**
  * @brief Equivalent to from_yamls<ptr_type_t<base_type>>(factory_configs, out);
  * @tparam BT base type
@@ -121,67 +374,220 @@ void from_yamls_base(YAML::Node const& factory_configs, OI out) {
 template <typename OT>
 void parse(OT& out, YAML::Node const& factory_config);
 
+/**
+ * @brief See parse(OT&, YAML::Node const&).
+ * @tparam OT output type
+ * @param out
+ * @param factory_config
+ */
+template <typename OT>
+void parse(OT& out, config_node const& factory_config);
+
 // ################# IMPL #####################
 template <typename FT>
-typename adapter<FT>::output_type create(std::string const& type, YAML::Node const& config) {
+typename adapter<FT>::output_type create(std::string_view type, YAML::Node const& config) {
     return adapter<FT>::create(type, config);
 }
 
+template <typename FT>
+typename adapter<FT>::output_type create(std::string_view type, config_node const& config) {
+    return adapter<FT>::create(type, config);
+}
+
+template <typename FT>
+create_result<typename adapter<FT>::output_type> try_create(std::string_view type, YAML::Node const& config) {
+    return details::try_adapter_create<adapter<FT>>(type, config);
+}
+
+template <typename FT>
+create_result<typename adapter<FT>::output_type> try_create(std::string_view type, config_node const& config) {
+    return details::try_adapter_create<adapter<FT>>(type, config);
+}
+
 template <typename OT>
 OT from_yaml(YAML::Node const& factory_config) {
+    return try_from_yaml<OT>(factory_config).value();
+}
+
+template <typename OT>
+OT from_yaml(config_node const& factory_config) {
+    return try_from_yaml<OT>(factory_config).value();
+}
+
+template <typename OT>
+create_result<OT> try_from_yaml(YAML::Node const& factory_config) {
     using BT = meta::derive_base_type_t<OT>;
 //    using DOT = OT;  // derive_output_type_t<OT>;
+    details::trace_span span;
+    if (trace_sink* sink = details::active_trace_sink()) {
+        details::begin_from_yaml_span<OT>(span, sink, factory_config);
+    }
+
+    // Scalars by value are parsed here rather than by yaml_as, other forms are left to it.  Traced creates get a span.
+    if constexpr (details::direct_scalar<OT>::value) {
+        OT value;
+        if (factory_config.IsScalar() && !details::active_trace_sink() && details::stock_by_value<OT, YAML::Node>() &&
+            details::parse_scalar(factory_config.Scalar(), value)) {
+            return value;
+        }
+    }
+
     if (adapter<OT>::direct_from_yaml) {
-        return adapter<BT>::create(type_by_value_key(), factory_config);
+        return details::to_output<OT>(details::try_adapter_create<adapter<BT>>(type_by_value_key(), factory_config));
     }
 
     if (!factory_config.IsDefined()) {
-        throw std::runtime_error("Factory config not defined");
+        return create_error(error_code::config_not_defined);
     }
 
+    // The type names are referenced in place, a std::string is only built for errors
     if (factory_config.IsScalar()) {
-        std::string type = factory_config.as<std::string>("");
+        std::string const& type = factory_config.Scalar();
         if (type.empty()) {
-            throw std::runtime_error("Factory config scalar not valid");
+            return create_error(error_code::scalar_not_valid);
         }
 
-        return adapter<BT>::create(type);
+        return details::to_output<OT>(details::try_adapter_create<adapter<BT>>(type, YAML::Node()));
     }
 
     if (factory_config.IsMap()) {
-        YAML::Node typeNode = factory_config["type"];
+        YAML::Node const typeNode = factory_config["type"];
         if (!typeNode.IsDefined()) {
-            throw std::runtime_error("Factory config type not defined");
+            return create_error(error_code::type_not_defined);
+        }
+        if (!typeNode.IsScalar() || typeNode.Scalar().empty()) {
+            return create_error(error_code::type_not_valid).within("type");
+        }
+
+        YAML::Node const configNode = factory_config["config"];
+        auto created = details::try_adapter_create<adapter<BT>>(typeNode.Scalar(), configNode);
+        bool const unknown = !created && created.error().code() == error_code::type_not_found;
+        return details::to_output<OT>(std::move(created), unknown ? "type" : "config");
+    }
+
+    return create_error(error_code::config_not_valid);
+}
+
+template <typename OT>
+create_result<OT> try_from_yaml(config_node const& factory_config) {
+    using BT = meta::derive_base_type_t<OT>;
+    details::trace_span span;
+    if (trace_sink* sink = details::active_trace_sink()) {
+        details::begin_from_yaml_span<OT>(span, sink, factory_config);
+    }
+
+    // The document already holds scalars converted, a failed conversion is left to config_as to report
+    if constexpr (details::direct_scalar<OT>::value) {
+        if (factory_config.IsScalar() && !details::active_trace_sink() && details::stock_by_value<OT, config_node>()) {
+            try {
+                return factory_config.template as<OT>();
+            } catch (std::exception const&) {
+            }
         }
-        std::string type = typeNode.as<std::string>("");
+    }
+
+    if (adapter<OT>::direct_from_yaml) {
+        return details::to_output<OT>(details::try_adapter_create<adapter<BT>>(type_by_value_key(), factory_config));
+    }
+
+    if (!factory_config.IsDefined()) {
+        return create_error(error_code::config_not_defined);
+    }
+
+    if (factory_config.IsScalar()) {
+        std::string_view const type = factory_config.Scalar();
         if (type.empty()) {
-            throw std::runtime_error("Factory config type not valid");
+            return create_error(error_code::scalar_not_valid);
+        }
+
+        return details::to_output<OT>(details::try_adapter_create<adapter<BT>>(type, config_node::null()));
+    }
+
+    if (factory_config.IsMap()) {
+        config_node const typeNode = factory_config["type"];
+        if (!typeNode.IsDefined()) {
+            return create_error(error_code::type_not_defined);
+        }
+        if (!typeNode.IsScalar() || typeNode.Scalar().empty()) {
+            return create_error(error_code::type_not_valid).within("type");
         }
 
-        YAML::Node configNode = factory_config["config"];
-        return adapter<BT>::create(type, configNode);
+        auto created = details::try_adapter_create<adapter<BT>>(typeNode.Scalar(), factory_config["config"]);
+        bool const unknown = !created && created.error().code() == error_code::type_not_found;
+        return details::to_output<OT>(std::move(created), unknown ? "type" : "config");
     }
 
-    throw std::runtime_error("Factory config not valid, YAML must be scalar string or map");
+    return create_error(error_code::config_not_valid);
 }
 
 template <typename OT, typename OI>
 void from_yamls(YAML::Node const& factory_configs, OI out) {
+    try_from_yamls<OT>(factory_configs, out).value();
+}
+
+template <typename OT, typename OI>
+void from_yamls(config_node const& factory_configs, OI out) {
+    try_from_yamls<OT>(factory_configs, out).value();
+}
+
+template <typename OT, typename OI>
+create_result<std::size_t> try_from_yamls(YAML::Node const& factory_configs, OI out) {
     if (!factory_configs.IsDefined()) {
-        throw std::runtime_error("From YAML factory configs not defined");
+        return create_error(error_code::configs_not_defined);
     }
     // If it's not a sequence then parse single
     if (!factory_configs.IsSequence()) {
-        *out = from_yaml<OT>(factory_configs);
+        create_result<OT> created = try_from_yaml<OT>(factory_configs);
+        if (!created) {
+            return std::move(created).error();
+        }
+        *out = std::move(*created);
         ++out;
-        return;
+        return std::size_t(1);
     }
 
     // A sequence!
+    std::size_t count = 0;
     for (YAML::Node const& entry : factory_configs) {
-        *out = from_yaml<OT>(entry);
+        create_result<OT> created = try_from_yaml<OT>(entry);
+        if (!created) {
+            create_error error = std::move(created).error();
+            return error.within("[" + std::to_string(count) + "]");
+        }
+        *out = std::move(*created);
+        ++out;
+        ++count;
+    }
+    return count;
+}
+
+template <typename OT, typename OI>
+create_result<std::size_t> try_from_yamls(config_node const& factory_configs, OI out) {
+    if (!factory_configs.IsDefined()) {
+        return create_error(error_code::configs_not_defined);
+    }
+    if (!factory_configs.IsSequence()) {
+        create_result<OT> created = try_from_yaml<OT>(factory_configs);
+        if (!created) {
+            return std::move(created).error();
+        }
+        *out = std::move(*created);
+        ++out;
+        return std::size_t(1);
+    }
+
+    std::size_t count = 0;
+    for (config_node const& entry : factory_configs) {
+        create_result<OT> created = try_from_yaml<OT>(entry);
+        if (!created) {
+            create_error error = std::move(created).error();
+            return error.within("[" + std::to_string(count) + "]");
+        }
+        *out = std::move(*created);
         ++out;
+        ++count;
     }
+    return count;
 }
 
 template <typename OT>
@@ -189,6 +595,11 @@ void parse(OT& out, YAML::Node const& factory_config) {
     out = from_yaml<OT>(factory_config);
 }
 
+template <typename OT>
+void parse(OT& out, config_node const& factory_config) {
+    out = from_yaml<OT>(factory_config);
+}
+
 }  // namespace yadi
 
 #endif  // YADI_CREATE_UTILS_HPP
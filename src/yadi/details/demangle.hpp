@@ -6,15 +6,20 @@
 #define YADI_DEMANGLE_HPP
 
 #include <string>
+#include <string_view>
 #include <typeinfo>
 
 namespace yadi {
 
 std::string demangle(const char* name);
 
+/**
+ * @brief The demangled name of T.  Demangled once, on first use.
+ */
 template <typename T>
-std::string demangle_type() {
-    return demangle(typeid(T).name());
+std::string_view demangle_type() {
+    static std::string const name = demangle(typeid(T).name());
+    return name;
 }
 
 }  // namespace yadi
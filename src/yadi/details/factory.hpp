@@ -5,15 +5,30 @@
 #ifndef YADI_FACTORY_HPP
 #define YADI_FACTORY_HPP
 
+#include "allocation.hpp"
+#include "concurrent_store.hpp"
+#include "config_ir.hpp"
 #include "demangle.hpp"
+#include "inline_function.hpp"
+#include "metrics.hpp"
+#include "perfect_hash.hpp"
+#include "create_result.hpp"
+#include "trace.hpp"
+#include "type_id.hpp"
 
 #include <yaml-cpp/yaml.h>
 
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #ifdef YADI_DEBUG
 #include <iostream>
@@ -49,9 +64,9 @@
     template struct ::yadi::factory<TYPE>;                                                                        \
     YADI_INIT_BEGIN_N(INIT_NAME)                                                                                  \
     ::yadi::register_factory<TYPE>(#TYPE);                                                                        \
-    ::yadi::register_type<TYPE>(::yadi::type_by_value_key(), ::yadi::make_yaml_as_initializer_with_help<TYPE>()); \
+    ::yadi::register_type_lazy<TYPE>(::yadi::type_by_value_key(),                                                 \
+                                     &::yadi::make_yaml_as_initializer_with_help<TYPE>);                          \
     YADI_INIT_END_N(INIT_NAME)
-
 /**
  * @namespace yadi
  * @brief YADI
@@ -66,6 +81,9 @@ template <typename BT>
 struct factory_traits {
     using ptr_type = std::unique_ptr<BT>;  /// The type of pointer to return from create.
     static constexpr bool direct_from_yaml = false;
+    /// How ctr, init_yaml and init_no_arg allocate, see new_allocation, pool_allocation and arena_allocation.
+    /// Specializations may leave this out for new_allocation.
+    using allocation = new_allocation;
 };
 
 /**
@@ -74,6 +92,31 @@ struct factory_traits {
 template <typename BT>
 using ptr_type_t = typename factory_traits<BT>::ptr_type;
 
+// \cond DEV_DOCS
+namespace details {
+
+template <typename BT, typename = void>
+struct allocation_policy {
+    using type = new_allocation;
+};
+
+template <typename BT>
+struct allocation_policy<BT, std::void_t<typename factory_traits<BT>::allocation>> {
+    using type = typename factory_traits<BT>::allocation;
+};
+
+/// Where an alias leads, see register_alias
+struct alias_hop;
+
+}  // namespace details
+// \endcond
+
+/**
+ * @brief The allocation policy of BT, factory_traits<BT>::allocation or new_allocation if it isn't given.
+ */
+template <typename BT>
+using allocation_policy_t = typename details::allocation_policy<BT>::type;
+
 // TODO YADI_DECL and YADI_DEFN macros with bit to add factory type to something for help retrieval
 /**
  * @brief A factory stores initializers and help informations for a given base type.
@@ -82,44 +125,225 @@ using ptr_type_t = typename factory_traits<BT>::ptr_type;
 template <typename BT>
 struct factory {
     using base_type = BT;
-    using initializer_type = std::function<ptr_type_t<base_type>(YAML::Node)>;
+    using initializer_type = details::inline_function<ptr_type_t<base_type>(YAML::Node const&)>;
+    using config_initializer_type = details::inline_function<ptr_type_t<base_type>(config_node const&)>;
     using ptr_type = ptr_type_t<base_type>;
 
+    struct lazy_registration;
+
     /**
      * @brief Helps initialier and help informations for a type.
      */
     struct yadi_info {
         initializer_type initializer;  ///< Initializer used to create an instance of a type.
-        std::string help;              ///< Help information for the initializer.
+        std::string help;              ///< Help information for the initializer.  Empty for a lazy registration.
+        /// Optional initializer reading a config_document node directly.  Without it the node is converted to YAML
+        /// and passed to initializer.
+        config_initializer_type config_initializer = {};
+        /// Set by register_lazy.  The initializers forward to the yadi_info it builds on first use.
+        std::shared_ptr<lazy_registration> lazy = {};
+        /// Set by register_alias, so chains of aliases are followed whatever the registration_mod wraps them in.
+        std::shared_ptr<details::alias_hop const> alias = {};
+#ifdef YADI_INSTRUMENT
+        std::size_t metrics_slot = 0;  ///< Where creates of the type are counted, set on registration
+#endif
+
+        /**
+         * @brief The help, built first if the registration is lazy.
+         */
+        std::string const& get_help() const { return this->lazy ? this->lazy->get().help : this->help; }
+    };
+
+    using lazy_initializer_type = details::inline_function<yadi_info()>;
+
+    /**
+     * @brief The yadi_info of a lazy registration, built by thunk once.  If thunk throws nothing is built, and the
+     * next get calls it again.
+     */
+    struct lazy_registration {
+        explicit lazy_registration(lazy_initializer_type thunk) : thunk(std::move(thunk)) {}
+
+        lazy_initializer_type thunk;
+        std::mutex mutex;                                 ///< Held while building
+        std::atomic<yadi_info const*> resolved{nullptr};  ///< Points to built once it's built
+        yadi_info built;
+
+        yadi_info const& get();
     };
 
-    using type_store = std::map<std::string, yadi_info>;
+    /// Transparent comparison allows lookup by std::string_view without building a std::string.
+    using type_store = std::map<std::string, yadi_info, std::less<>>;
 
     /**
      * @brief Registers initializer to type.  When create is called with type this initializer will
-     * be called. Overwrites initializer if already registered (will change).
+     * be called. Overwrites initializer if already registered (will change).  Registration may happen while other
+     * threads call create, concurrent registrations are serialized.
      * @param type
      * @param initializer
+     * @throws std::runtime_error if the factory is frozen
      */
     static void register_type(std::string type, yadi_info yadis);
 
     /**
-     * @brief Calls the initializer associated with type passing the given YAML config.
+     * @brief Registers type to the yadi_info returned by thunk, which isn't called until type is first created or
+     * its help is read.  Defers building closures and help text, such as demangled argument types, so registering
+     * types that are never used costs little more than storing the name.
+     * @param type
+     * @param thunk
+     * @throws std::runtime_error if the factory is frozen
+     */
+    static void register_lazy(std::string type, lazy_initializer_type thunk);
+
+    /**
+     * @brief Compacts the registered types into a read-only perfect hash table which create uses from then on.
+     * Intended to be called once all types are registered, typically at the start of main.  Registering a type after
+     * the factory is frozen is an error.  Calling freeze more than once has no effect.
+     */
+    static void freeze();
+
+    /**
+     * @brief Whether freeze has been called.
+     * @return
+     */
+    static bool frozen();
+
+    /**
+     * @brief Calls the initializer associated with type passing the given YAML config.  The lookup does not lock or
+     * allocate.
+     * @param type
+     * @param config
+     * @return The result of the registered initializer
+     * @throws std::runtime_error if no initializer is registered for type
+     */
+    static ptr_type create(std::string_view type, YAML::Node const& config = {});
+
+    /**
+     * @brief Calls the initializer registered to the type with ID type, found by indexing a flat table rather than
+     * hashing the name.  The lookup does not lock or allocate.
+     * @param type ID from resolve
+     * @param config
+     * @return The result of the registered initializer
+     * @throws std::runtime_error if no initializer is registered for type
+     */
+    static ptr_type create(type_id type, YAML::Node const& config = {});
+
+    /**
+     * @brief Same as create(type, YAML::Node) with config read from a config_document.  Uses the config_initializer
+     * registered to type if any, otherwise converts config to YAML for the initializer.
      * @param type
      * @param config
      * @return The result of the registered initializer
      * @throws std::runtime_error if no initializer is registered for type
      */
-    static ptr_type create(std::string const& type, YAML::Node const& config = {});
+    static ptr_type create(std::string_view type, config_node const& config);
+
+    /**
+     * @brief See create(std::string_view, config_node const&) and create(type_id, YAML::Node const&).
+     * @param type
+     * @param config
+     * @return
+     */
+    static ptr_type create(type_id type, config_node const& config);
+
+    /**
+     * @brief Same as create(std::string_view, YAML::Node const&) but reports failures in the result rather than
+     * throwing.  A missing type doesn't throw at all, an initializer that throws is caught and returned as the cause
+     * of an initializer_failed error.  The error message is only built if asked for.
+     * @param type
+     * @param config
+     * @return The created instance or the error
+     */
+    static create_result<ptr_type> try_create(std::string_view type, YAML::Node const& config = {});
+
+    /**
+     * @brief See try_create(std::string_view, YAML::Node const&) and create(type_id, YAML::Node const&).
+     */
+    static create_result<ptr_type> try_create(type_id type, YAML::Node const& config = {});
+
+    /**
+     * @brief See try_create(std::string_view, YAML::Node const&) and create(std::string_view, config_node const&).
+     */
+    static create_result<ptr_type> try_create(std::string_view type, config_node const& config);
+
+    /**
+     * @brief See try_create(std::string_view, YAML::Node const&) and create(type_id, config_node const&).
+     */
+    static create_result<ptr_type> try_create(type_id type, config_node const& config);
+
+    /**
+     * @brief ID of a registered type for use with create(type_id, config).  The ID stays valid if the type is
+     * registered again, in which case create uses the new initializer.
+     * @param type
+     * @return
+     * @throws std::runtime_error if type isn't registered
+     */
+    static type_id resolve(std::string_view type);
+
+    /**
+     * @brief The initializer and help registered to type.  The lookup does not lock.
+     * @param type
+     * @return The registered yadi_info, valid for the life of the factory even if type is registered again, or nullptr.
+     */
+    static yadi_info const* find(std::string_view type);
+
+    /**
+     * @brief Number of registrations so far.  Lets callers caching lookups notice that a type was registered again.
+     * @return
+     */
+    static std::uint64_t generation();
 
     /**
-     * @brief Stored types and their registered initializers and help.
+     * @brief Stored types and their registered initializers and help.  Unlike create, iterating the store is not safe
+     * while another thread registers types.
      * @return
      */
     static type_store const& types();
 
    private:
-    static type_store& mut_types();
+    // \cond DEV_DOCS
+    struct frozen_entry {
+        std::uint64_t hash = 0;  ///< perfect_hash::key_hash of type
+        std::string_view type;   ///< Refers to the key in types
+        yadi_info const* yadis = nullptr;
+    };
+
+    struct frozen_type_store {
+        details::perfect_hash hash;
+        std::vector<frozen_entry> entries;  ///< Indexed by hash slot
+    };
+
+    /**
+     * @brief Registration state.  Writers hold write_mutex while create reads index, or frozen_types once frozen,
+     * without taking a lock.
+     */
+    struct registry {
+        std::mutex write_mutex;
+        type_store types;                            ///< Every registered type, for enumeration and help.
+        details::concurrent_store<yadi_info> index;  ///< Used by create until frozen.
+        details::concurrent_table<yadi_info> by_id;  ///< Values owned by index, indexed by type_id.
+        std::unique_ptr<frozen_type_store const> frozen_store;
+        std::atomic<frozen_type_store const*> frozen_types{nullptr};
+        std::atomic<std::uint64_t> generation{0};
+    };
+    // \endcond
+
+    static yadi_info const* find_type(std::string_view type);
+
+    static yadi_info apply_registration_mod(yadi_info yadis);
+
+    static void store(std::string type, yadi_info yadis);
+
+    /**
+     * @brief Calls the initializer of yadis.  The type name used in errors is type, or if empty the name of id.
+     * Failures are thrown if RT is ptr_type, and returned if it's create_result<ptr_type>.
+     */
+    template <typename RT, typename CT>
+    static RT invoke(yadi_info const* yadis, type_id id, std::string_view type, CT const& config);
+
+    template <typename RT>
+    static RT fail(error_code code, std::string_view type, std::exception_ptr cause = {});
+
+    static registry& mut_registry();
 };
 
 template <typename BT>
@@ -131,43 +355,244 @@ using yadi_info_t = typename factory<BT>::yadi_info;
 
 template <typename BT>
 struct registration_mod {
+    static constexpr bool is_default = true;  ///< Specializations leave this out
     static yadi_info_t<BT> mod(yadi_info_t<BT> && yadis);
 };
 
+// \cond DEV_DOCS
+namespace details {
+
+template <typename BT, typename = void>
+struct is_default_registration_mod : std::false_type {};
+
+template <typename BT>
+struct is_default_registration_mod<BT, std::void_t<decltype(registration_mod<BT>::is_default)>> : std::true_type {};
+
+}  // namespace details
+// \endcond
+
 
 // ############################ IMPL ############################
 
 template <typename BT>
 void factory<BT>::register_type(std::string type, yadi_info yadis) {
+    store(std::move(type), apply_registration_mod(std::move(yadis)));
+}
+
+template <typename BT>
+void factory<BT>::register_lazy(std::string type, lazy_initializer_type thunk) {
+    std::shared_ptr<lazy_registration> lazy(new lazy_registration(std::move(thunk)));
+    yadi_info yadis;
+    yadis.initializer = [lazy](YAML::Node const& config) { return lazy->get().initializer(config); };
+    yadis.config_initializer = [lazy](config_node const& config) {
+        yadi_info const& resolved = lazy->get();
+        return resolved.config_initializer ? resolved.config_initializer(config)
+                                           : resolved.initializer(config.to_yaml());
+    };
+    yadis.lazy = std::move(lazy);
+    // The mod is applied to the yadi_info the thunk builds
+    store(std::move(type), std::move(yadis));
+}
+
+template <typename BT>
+typename factory<BT>::yadi_info const& factory<BT>::lazy_registration::get() {
+    if (yadi_info const* resolved = this->resolved.load(std::memory_order_acquire)) {
+        return *resolved;
+    }
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->resolved.load(std::memory_order_relaxed)) {
+        this->built = apply_registration_mod(this->thunk());
+        this->thunk = nullptr;
+        this->resolved.store(&this->built, std::memory_order_release);
+    }
+    return this->built;
+}
+
+template <typename BT>
+typename factory<BT>::yadi_info factory<BT>::apply_registration_mod(yadi_info yadis) {
+    if constexpr (!details::is_default_registration_mod<BT>::value) {
+        // A mod only knows about the YAML initializer, so the node is converted to YAML for it to take effect
+        yadis.config_initializer = nullptr;
+    }
+    // The alias describes the registration rather than the initializer, so it's kept whatever the mod does
+    std::shared_ptr<details::alias_hop const> alias = yadis.alias;
+    yadi_info modded = registration_mod<BT>::mod(std::move(yadis));
+    modded.alias = std::move(alias);
+    return modded;
+}
+
+template <typename BT>
+void factory<BT>::store(std::string type, yadi_info yadis) {
 #ifdef YADI_DEBUG
-    std::cerr << "Registering \"" + type + "\" to \"" + demangle_type<BT>() + "\" factory\n";
+    std::cerr << "Registering \"" << type << "\" to \"" << demangle_type<BT>() << "\" factory\n";
 #endif
-    mut_types()[type] = registration_mod<BT>::mod(std::move(yadis));
+#ifdef YADI_INSTRUMENT
+    yadis.metrics_slot = details::create_metrics_slot(demangle_type<BT>(), type);
+#endif
+    registry& reg = mut_registry();
+    std::lock_guard<std::mutex> lock(reg.write_mutex);
+    if (reg.frozen_store) {
+        throw std::runtime_error("Unable to register \"" + type + "\", \"" + std::string(demangle_type<BT>()) +
+                                 "\" factory is frozen");
+    }
+    type_id const id = type_id::intern(type);
+    reg.types[type] = yadis;
+    reg.by_id.assign(id.value(), reg.index.assign(type, std::move(yadis)));
+    reg.generation.fetch_add(1, std::memory_order_release);
+}
+
+template <typename BT>
+void factory<BT>::freeze() {
+    registry& reg = mut_registry();
+    std::lock_guard<std::mutex> lock(reg.write_mutex);
+    if (reg.frozen_store) {
+        return;
+    }
+
+    std::vector<std::string_view> keys;
+    for (auto const& entry : reg.types) {
+        keys.push_back(entry.first);
+    }
+
+    std::unique_ptr<frozen_type_store> store(new frozen_type_store{details::perfect_hash(keys), {}});
+    store->entries.resize(store->hash.slot_count());
+    for (auto const& entry : reg.types) {
+        std::uint64_t const hash = store->hash.key_hash(entry.first);
+        store->entries[store->hash.slot_of(hash)] = {hash, entry.first, reg.index.find(entry.first)};
+    }
+    reg.frozen_types.store(store.get(), std::memory_order_release);
+    reg.frozen_store = std::move(store);
+}
+
+template <typename BT>
+bool factory<BT>::frozen() {
+    return mut_registry().frozen_types.load(std::memory_order_acquire) != nullptr;
+}
+
+template <typename BT>
+typename factory<BT>::yadi_info const* factory<BT>::find_type(std::string_view type) {
+    registry const& reg = mut_registry();
+    if (frozen_type_store const* frozen_types = reg.frozen_types.load(std::memory_order_acquire)) {
+        std::uint64_t const hash = frozen_types->hash.key_hash(type);
+        frozen_entry const& entry = frozen_types->entries[frozen_types->hash.slot_of(hash)];
+        return (entry.hash == hash && entry.type == type) ? entry.yadis : nullptr;
+    }
+
+    return reg.index.find(type);
+}
+
+template <typename BT>
+typename factory<BT>::ptr_type factory<BT>::create(std::string_view type, YAML::Node const& config) {
+    return invoke<ptr_type>(find_type(type), type_id(), type, config);
+}
+
+template <typename BT>
+typename factory<BT>::ptr_type factory<BT>::create(type_id type, YAML::Node const& config) {
+    return invoke<ptr_type>(mut_registry().by_id.find(type.value()), type, {}, config);
+}
+
+template <typename BT>
+typename factory<BT>::ptr_type factory<BT>::create(std::string_view type, config_node const& config) {
+    return invoke<ptr_type>(find_type(type), type_id(), type, config);
+}
+
+template <typename BT>
+typename factory<BT>::ptr_type factory<BT>::create(type_id type, config_node const& config) {
+    return invoke<ptr_type>(mut_registry().by_id.find(type.value()), type, {}, config);
+}
+
+template <typename BT>
+create_result<typename factory<BT>::ptr_type> factory<BT>::try_create(std::string_view type, YAML::Node const& config) {
+    return invoke<create_result<ptr_type>>(find_type(type), type_id(), type, config);
+}
+
+template <typename BT>
+create_result<typename factory<BT>::ptr_type> factory<BT>::try_create(type_id type, YAML::Node const& config) {
+    return invoke<create_result<ptr_type>>(mut_registry().by_id.find(type.value()), type, {}, config);
+}
+
+template <typename BT>
+create_result<typename factory<BT>::ptr_type> factory<BT>::try_create(std::string_view type,
+                                                                      config_node const& config) {
+    return invoke<create_result<ptr_type>>(find_type(type), type_id(), type, config);
+}
+
+template <typename BT>
+create_result<typename factory<BT>::ptr_type> factory<BT>::try_create(type_id type, config_node const& config) {
+    return invoke<create_result<ptr_type>>(mut_registry().by_id.find(type.value()), type, {}, config);
 }
 
 template <typename BT>
-typename factory<BT>::ptr_type factory<BT>::create(std::string const& type, YAML::Node const& config) {
-    typename type_store::const_iterator type_iter = mut_types().find(type);
-    if (type_iter == mut_types().end()) {
-        throw std::runtime_error("\"" + type + "\" not found in \"" + demangle_type<BT>() + "\" factory");
+type_id factory<BT>::resolve(std::string_view type) {
+    type_id const id = type_id::find(type);
+    if (!mut_registry().by_id.find(id.value())) {
+        fail<ptr_type>(error_code::type_not_found, type);
     }
+    return id;
+}
 
+template <typename BT>
+template <typename RT, typename CT>
+RT factory<BT>::invoke(yadi_info const* yadis, type_id id, std::string_view type, CT const& config) {
+    details::trace_span span;
+    if (trace_sink* sink = details::active_trace_sink()) {
+        span.begin(sink, trace_kind::create, demangle_type<BT>(), type.empty() ? id.name() : type);
+    }
+
+    if (!yadis) {
+        return fail<RT>(error_code::type_not_found, type.empty() ? id.name() : type);
+    }
+
+#ifdef YADI_INSTRUMENT
+    details::create_timer timer(yadis->metrics_slot);
+#endif
     try {
-        return type_iter->second.initializer(config);
-    } catch(std::exception const& ex) {
-        throw std::runtime_error("Error creating \"" + type + "\": " + ex.what());
+        if constexpr (std::is_same<CT, config_node>::value) {
+            if (yadis->config_initializer) {
+                return yadis->config_initializer(config);
+            }
+            return yadis->initializer(config.to_yaml());
+        } else {
+            return yadis->initializer(config);
+        }
+    } catch(std::exception const&) {
+#ifdef YADI_INSTRUMENT
+        timer.fail();
+#endif
+        return fail<RT>(error_code::initializer_failed, type.empty() ? id.name() : type, std::current_exception());
+    }
+}
+
+template <typename BT>
+template <typename RT>
+RT factory<BT>::fail(error_code code, std::string_view type, std::exception_ptr cause) {
+    create_error error(code, std::string(type), demangle_type<BT>(), std::move(cause));
+    if constexpr (std::is_same<RT, ptr_type>::value) {
+        error.raise();
+    } else {
+        return error;
     }
 }
 
+template <typename BT>
+typename factory<BT>::yadi_info const* factory<BT>::find(std::string_view type) {
+    return find_type(type);
+}
+
+template <typename BT>
+std::uint64_t factory<BT>::generation() {
+    return mut_registry().generation.load(std::memory_order_acquire);
+}
+
 template <typename BT>
 typename factory<BT>::type_store const& factory<BT>::types() {
-    return mut_types();
+    return mut_registry().types;
 }
 
 template <typename BT>
-typename factory<BT>::type_store& factory<BT>::mut_types() {
-    static type_store TYPES;
-    return TYPES;
+typename factory<BT>::registry& factory<BT>::mut_registry() {
+    static registry REGISTRY;
+    return REGISTRY;
 }
 
 template <typename BT>
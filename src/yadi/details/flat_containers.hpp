@@ -0,0 +1,207 @@
+#ifndef YADI_FLAT_CONTAINERS_HPP
+#define YADI_FLAT_CONTAINERS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Set stored as a sorted std::vector, for lookup tables that are built once and read often.  Lookups are a
+ * binary search over contiguous memory, inserting is linear.
+ * @tparam K Key type
+ * @tparam C Key comparison
+ */
+template <typename K, typename C = std::less<K>>
+class flat_set {
+   public:
+    using key_type = K;
+    using value_type = K;
+    using key_compare = C;
+    using container_type = std::vector<K>;
+    using size_type = std::size_t;
+    using iterator = typename container_type::const_iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    flat_set() = default;
+
+    /**
+     * @brief Takes values in any order, repeated values are kept once.
+     * @param values
+     */
+    explicit flat_set(container_type values) : values(std::move(values)) {
+        std::sort(this->values.begin(), this->values.end(), key_compare());
+        this->values.erase(std::unique(this->values.begin(), this->values.end(), equivalent), this->values.end());
+    }
+
+    const_iterator begin() const { return this->values.begin(); }
+    const_iterator end() const { return this->values.end(); }
+    size_type size() const { return this->values.size(); }
+    bool empty() const { return this->values.empty(); }
+
+    const_iterator lower_bound(K const& key) const {
+        return std::lower_bound(this->values.begin(), this->values.end(), key, key_compare());
+    }
+
+    const_iterator find(K const& key) const {
+        const_iterator const found = this->lower_bound(key);
+        return found != this->end() && !key_compare()(key, *found) ? found : this->end();
+    }
+
+    bool contains(K const& key) const { return this->find(key) != this->end(); }
+    size_type count(K const& key) const { return this->contains(key) ? 1 : 0; }
+
+    std::pair<const_iterator, bool> insert(K value) {
+        const_iterator const found = this->lower_bound(value);
+        if (found != this->end() && !key_compare()(value, *found)) {
+            return {found, false};
+        }
+        return {this->values.insert(found, std::move(value)), true};
+    }
+
+    /**
+     * @brief The sorted values.
+     */
+    container_type const& sequence() const { return this->values; }
+
+    friend bool operator==(flat_set const& left, flat_set const& right) { return left.values == right.values; }
+    friend bool operator!=(flat_set const& left, flat_set const& right) { return left.values != right.values; }
+
+   private:
+    static bool equivalent(K const& left, K const& right) {
+        return !key_compare()(left, right) && !key_compare()(right, left);
+    }
+
+    container_type values;
+};
+
+/**
+ * @brief Map stored as a std::vector of entries sorted by key, see flat_set.  Iterators allow changing values, keys
+ * must not be changed.
+ * @tparam K Key type
+ * @tparam V Mapped type
+ * @tparam C Key comparison
+ */
+template <typename K, typename V, typename C = std::less<K>>
+class flat_map {
+   public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = C;
+    using container_type = std::vector<value_type>;
+    using size_type = std::size_t;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    flat_map() = default;
+
+    /**
+     * @brief Takes entries in any order.  If a key is repeated the last entry with it is kept, as assigning each
+     * entry in turn to a std::map would.
+     * @param entries
+     */
+    explicit flat_map(container_type entries) : entries(std::move(entries)) {
+        std::stable_sort(this->entries.begin(), this->entries.end(), entry_less);
+        // Keep the last of each run of equal keys
+        iterator kept = this->entries.begin();
+        for (iterator it = this->entries.begin(); it != this->entries.end(); ++it) {
+            if (std::next(it) != this->entries.end() && !key_compare()(it->first, std::next(it)->first)) {
+                continue;
+            }
+            if (kept != it) {
+                *kept = std::move(*it);
+            }
+            ++kept;
+        }
+        this->entries.erase(kept, this->entries.end());
+    }
+
+    iterator begin() { return this->entries.begin(); }
+    iterator end() { return this->entries.end(); }
+    const_iterator begin() const { return this->entries.begin(); }
+    const_iterator end() const { return this->entries.end(); }
+    size_type size() const { return this->entries.size(); }
+    bool empty() const { return this->entries.empty(); }
+
+    iterator lower_bound(K const& key) {
+        return std::lower_bound(this->entries.begin(), this->entries.end(), key, key_less);
+    }
+
+    const_iterator lower_bound(K const& key) const {
+        return std::lower_bound(this->entries.begin(), this->entries.end(), key, key_less);
+    }
+
+    iterator find(K const& key) {
+        iterator const found = this->lower_bound(key);
+        return found != this->end() && !key_compare()(key, found->first) ? found : this->end();
+    }
+
+    const_iterator find(K const& key) const {
+        const_iterator const found = this->lower_bound(key);
+        return found != this->end() && !key_compare()(key, found->first) ? found : this->end();
+    }
+
+    bool contains(K const& key) const { return this->find(key) != this->end(); }
+    size_type count(K const& key) const { return this->contains(key) ? 1 : 0; }
+
+    /**
+     * @throws std::out_of_range if key isn't in the map
+     */
+    V& at(K const& key) {
+        iterator const found = this->find(key);
+        if (found == this->end()) {
+            throw std::out_of_range("Key not in flat_map");
+        }
+        return found->second;
+    }
+
+    /**
+     * @throws std::out_of_range if key isn't in the map
+     */
+    V const& at(K const& key) const {
+        const_iterator const found = this->find(key);
+        if (found == this->end()) {
+            throw std::out_of_range("Key not in flat_map");
+        }
+        return found->second;
+    }
+
+    std::pair<iterator, bool> insert_or_assign(K key, V value) {
+        iterator const found = this->lower_bound(key);
+        if (found != this->end() && !key_compare()(key, found->first)) {
+            found->second = std::move(value);
+            return {found, false};
+        }
+        return {this->entries.emplace(found, std::move(key), std::move(value)), true};
+    }
+
+    /**
+     * @brief The entries sorted by key.
+     */
+    container_type const& sequence() const { return this->entries; }
+
+    friend bool operator==(flat_map const& left, flat_map const& right) { return left.entries == right.entries; }
+    friend bool operator!=(flat_map const& left, flat_map const& right) { return left.entries != right.entries; }
+
+   private:
+    static bool entry_less(value_type const& left, value_type const& right) {
+        return key_compare()(left.first, right.first);
+    }
+
+    static bool key_less(value_type const& entry, K const& key) { return key_compare()(entry.first, key); }
+
+    container_type entries;
+};
+
+}  // namespace yadi
+
+#endif  // YADI_FLAT_CONTAINERS_HPP
@@ -17,6 +17,8 @@ yadi_help_fetcher& yadi_help_fetcher::operator=(yadi_help_fetcher const& other)
 yadi_help::help_store const& yadi_help::helps() { return mut_helps(); }
 yadi_help::name_store const& yadi_help::names() { return mut_names(); }
 
+std::uint64_t yadi_help::names_generation() { return mut_names_generation().load(std::memory_order_acquire); }
+
 yadi_help::help_store& yadi_help::mut_helps() {
     static help_store HELPS;
     return HELPS;
@@ -27,4 +29,9 @@ yadi_help::name_store& yadi_help::mut_names() {
     return NAMES;
 }
 
+std::atomic<std::uint64_t>& yadi_help::mut_names_generation() {
+    static std::atomic<std::uint64_t> GENERATION{0};
+    return GENERATION;
+}
+
 }  // namespace yadi
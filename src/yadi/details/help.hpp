@@ -7,10 +7,14 @@
 
 #include "demangle.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <typeindex>
 #include <vector>
 
@@ -43,7 +47,7 @@ struct yadi_help_fetcher {
                 throw std::runtime_error("Type \"" + type + "\" not found");
             }
 
-            return types_iter->second.help;
+            return types_iter->second.get_help();
         }
 
         std::vector<std::string> get_types() const override {
@@ -93,6 +97,7 @@ struct yadi_help {
     static void register_factory(std::string name, TS const& types) {
         mut_helps()[name] = types;
         mut_names()[std::type_index(typeid(BT))] = name;
+        mut_names_generation().fetch_add(1, std::memory_order_release);
     }
 
     template <typename BT>
@@ -101,24 +106,82 @@ struct yadi_help {
         return name_iter != names().end();
     }
 
+    /**
+     * @brief The name registered for BT, or its demangled name.  Looked up once and again only after a factory name
+     * is registered.
+     */
     template <typename BT>
-    static std::string get_name() {
-        auto const& name_iter = names().find(std::type_index(typeid(BT)));
-        if (name_iter != names().end()) {
-            return name_iter->second;
-        }
-
-        return demangle_type<BT>();
-    }
+    static std::string_view get_name();
 
     static help_store const& helps();
     static name_store const& names();
 
+    /**
+     * @brief Incremented each time a factory name is registered.
+     */
+    static std::uint64_t names_generation();
+
    private:
     static help_store& mut_helps();
     static name_store& mut_names();
+    static std::atomic<std::uint64_t>& mut_names_generation();
 };
 
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief A name composed on first use, and composed again if a factory name has been registered since, as that may
+ * change it.  Replaced names are kept since callers may still hold a view of them.
+ */
+class name_cache {
+   public:
+    template <typename F>
+    std::string_view get(F&& compose) {
+        entry const* current = this->current.load(std::memory_order_acquire);
+        if (current && current->generation == yadi_help::names_generation()) {
+            return current->name;
+        }
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        std::uint64_t const generation = yadi_help::names_generation();
+        current = this->current.load(std::memory_order_relaxed);
+        if (current && current->generation == generation) {
+            return current->name;
+        }
+        this->entries.emplace_back(new entry{generation, std::string(compose())});
+        current = this->entries.back().get();
+        this->current.store(current, std::memory_order_release);
+        return current->name;
+    }
+
+   private:
+    struct entry {
+        std::uint64_t generation;
+        std::string name;
+    };
+
+    std::mutex mutex;
+    std::atomic<entry const*> current{nullptr};
+    std::vector<std::unique_ptr<entry const>> entries;
+};
+
+}  // namespace details
+// \endcond
+
+template <typename BT>
+std::string_view yadi_help::get_name() {
+    static details::name_cache cache;
+    return cache.get([]() -> std::string {
+        auto const& name_iter = names().find(std::type_index(typeid(BT)));
+        if (name_iter != names().end()) {
+            return name_iter->second;
+        }
+
+        return std::string(demangle_type<BT>());
+    });
+}
+
 }  // namespace yadi
 
 #endif  // YADI_HELP_HPP
@@ -14,5 +14,19 @@ std::string formatFields(std::vector<std::string> const &fields) {
     return fieldsStr += "]";
 }
 
+namespace details {
+
+map_binding_plan::map_binding_plan(std::vector<std::string> fields)
+    : field_names(std::move(fields)),
+      formatted(formatFields(this->field_names)),
+      hash(std::vector<std::string_view>(this->field_names.begin(), this->field_names.end())),
+      slots(this->hash.slot_count(), npos) {
+    for (std::size_t i = 0; i < this->field_names.size(); ++i) {
+        this->slots[this->hash.slot(this->field_names[i])] = i;
+    }
+}
+
+}  // namespace details
+
 } // end namespace yadi
 
@@ -9,9 +9,16 @@
 #include "create_utils.hpp"
 #include "factory.hpp"
 #include "help.hpp"
+#include "instance_cache.hpp"
+#include "perfect_hash.hpp"
 #include "type_utils.hpp"
+#include "yaml_hash.hpp"
 
+#include <algorithm>
+#include <array>
 #include <optional>
+#include <string_view>
+#include <tuple>
 
 
 /**
@@ -46,6 +53,15 @@ ptr_type_t<BT> ctr(ARGS... args);
 template <typename T>
 T yaml_as(YAML::Node const& config);
 
+/**
+ * @brief Returns config.as<T>().  Signature matches factory config initializer.
+ * @tparam T
+ * @param config
+ * @return
+ */
+template <typename T>
+T config_as(config_node const& config);
+
 /**
  * @brief Call no argument constructor.
  * @tparam BT Base type.
@@ -66,11 +82,12 @@ ptr_type_t<BT> init_no_arg(YAML::Node const&);
 template <typename BT, typename IT>
 ptr_type_t<BT> init_yaml(YAML::Node const& config);
 
-// TODO thread safe
 /**
  * @brief Wraps initializer in caching functor. The wrapped initializer must produce a shared pointer.  A weak pointer
  * to the created shared pointer is stored upon first creation.  In subsequence calls the weak pointer is checking and
- * used if it's still valid, otherwise a new shared pointer is created and the weak pointer is updated.
+ * used if it's still valid, otherwise a new shared pointer is created and the weak pointer is updated.  The functor is
+ * thread safe, concurrent calls with the same config create a single instance, and entries whose instance expired are
+ * removed as the cache grows.  Configs are compared structurally, see yaml_equal, so map key order doesn't matter.
  * @tparam BT base type
  * @param initializing_initializer The initializer to wrap, which is used to create the shared pointer.
  * @return An existing instance if it exists, otherwise a new instance is created.
@@ -110,9 +127,10 @@ template <typename BT, typename F>
 yadi_info_t<BT> make_single_arg_initializer_with_help(F func, std::string help);
 
 /**
- * @brief Expects a YAML map.  The fields are pulled from the map and their values are used to create a sequence
- * in the order the fields are provided.  Once the sequence is created it's treated the behavior is the same as
- * make_sequence_initializer(F). Throws an exception if strictFields is true and the yaml contains an element that isn't one of the fields.
+ * @brief Expects a YAML map.  The fields are pulled from the map and their values are used as the arguments to func
+ * in the order the fields are provided, the same as make_sequence_initializer(F) would for a sequence.  The field
+ * lookup is compiled once here rather than on each call.  Throws an exception if strictFields is true and the yaml
+ * contains an element that isn't one of the fields, and up front if a field is repeated.
  * @tparam BT
  * @tparam F
  * @param func
@@ -232,8 +250,7 @@ struct init_yaml_helper;
 template <typename BT, typename IT>
 struct init_yaml_helper<BT, IT, false> {
     static ptr_type_t<BT> init(YAML::Node const& config) {
-        ptr_type_t<BT> ret(new IT(config));
-        return ret;
+        return allocation_policy_t<BT>::template make<ptr_type_t<BT>, IT>(config);
     }
 };
 
@@ -252,8 +269,7 @@ struct init_no_arg_helper;
 template <typename BT, typename IT>
 struct init_no_arg_helper<BT, IT, false> {
     static ptr_type_t<BT> init() {
-        ptr_type_t<BT> ret(new IT);
-        return ret;
+        return allocation_policy_t<BT>::template make<ptr_type_t<BT>, IT>();
     }
 };
 
@@ -283,8 +299,7 @@ template <typename BT, typename IT>
 struct ctr_helper<BT, IT, false> {
     template <typename... ARGS>
     static ptr_type_t<BT> init(ARGS... args) {
-        ptr_type_t<BT> instance(new IT(std::move(args)...));
-        return instance;
+        return allocation_policy_t<BT>::template make<ptr_type_t<BT>, IT>(std::move(args)...);
     }
 };
 
@@ -309,20 +324,70 @@ public:
     }
 };
 
+/**
+ * @brief Populates element I of out from field_config, a YAML::Node or config_node.
+ */
+template <typename tuple_t, std::size_t I, typename CT>
+void tuple_element_from_yaml(tuple_t& out, CT const& field_config) {
+    using element_type = meta::bare_t<std::tuple_element_t<I, tuple_t>>;
+    // Skip optional fields with undefined or null YAML
+    if (!is_optional_v<element_type> || (field_config.IsDefined() && !field_config.IsNull())) {
+        try {
+            std::get<I>(out) = ::yadi::from_yaml<element_type>(field_config);
+        } catch (std::exception const& ex) {
+            throw yadi_mapping_exception(I, ex.what());
+        }
+    }
+}
+
+/**
+ * @brief Populates the element at runtime index of out from field_config.
+ */
+template <typename tuple_t, typename CT, std::size_t... I>
+void tuple_element_from_yaml(tuple_t& out, std::size_t index, CT const& field_config, std::index_sequence<I...>) {
+    (void)((I == index && (tuple_element_from_yaml<tuple_t, I>(out, field_config), true)) || ...);
+}
+
+/**
+ * @brief Field names of a map initializer compiled once at registration.  Maps a field name to its argument index via
+ * a perfect hash, so binding a YAML map is one pass over its entries.
+ */
+class map_binding_plan {
+   public:
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    explicit map_binding_plan(std::vector<std::string> fields);
+
+    /**
+     * @brief Argument index of field.
+     * @param field
+     * @return The index or npos if field isn't one of the fields.
+     */
+    std::size_t index_of(std::string_view field) const {
+        std::size_t const index = this->slots[this->hash.slot(field)];
+        return (index != npos && this->field_names[index] == field) ? index : npos;
+    }
+
+    std::vector<std::string> const& fields() const { return this->field_names; }
+
+    /**
+     * @brief The fields formatted for error messages, see formatFields.
+     */
+    std::string const& formatted_fields() const { return this->formatted; }
+
+   private:
+    std::vector<std::string> field_names;
+    std::string formatted;
+    perfect_hash hash;
+    std::vector<std::size_t> slots;  ///< Argument index for each hash slot
+};
+
 template <typename tuple_t, size_t index = std::tuple_size<tuple_t>::value - 1>
 struct yaml_to_tuple {
-    static void to_tuple(tuple_t& out, YAML::Node const& yaml) {
-        using element_type = meta::bare_t<std::tuple_element_t<std::tuple_size<tuple_t>::value - 1 - index, tuple_t>>;
-        // Skip optional fields with undefined or null YAML
-        YAML::Node field_config = yaml[std::tuple_size<tuple_t>::value - 1 - index];
-        if (!is_optional_v<element_type> || (field_config.IsDefined() && !field_config.IsNull())) {
-            try {
-                std::get<std::tuple_size<tuple_t>::value - 1 - index>(out) =
-                        ::yadi::from_yaml<element_type>(field_config);
-            } catch(std::exception const& ex) {
-                throw yadi_mapping_exception(std::tuple_size<tuple_t>::value - 1 - index, ex.what());
-            }
-        }
+    template <typename CT>
+    static void to_tuple(tuple_t& out, CT const& yaml) {
+        constexpr std::size_t element_index = std::tuple_size<tuple_t>::value - 1 - index;
+        tuple_element_from_yaml<tuple_t, element_index>(out, yaml[element_index]);
 
         if constexpr (index != 0) {
             yaml_to_tuple<tuple_t, index - 1>::to_tuple(out, yaml);
@@ -332,7 +397,7 @@ struct yaml_to_tuple {
     template <typename arg_type_out>
     static void to_arg_types(arg_type_out arg_types) {
         using element_type = meta::bare_t<std::tuple_element_t<std::tuple_size<tuple_t>::value - 1 - index, tuple_t>>;
-        arg_types = adapter<element_type>::get_name();
+        arg_types = std::string(adapter<element_type>::get_name());
         arg_types++;
         if constexpr (index != 0) {
             yaml_to_tuple<tuple_t, index - 1>::to_arg_types(arg_types);
@@ -410,6 +475,102 @@ template <typename F>
 function_traits_result_type<F> call_from_yaml(F const& func, YAML::Node const& yaml) {
     return function_call_via_yaml<F>::call(func, yaml);
 }
+
+/**
+ * @brief Calls func with its arguments created from the elements of sequence config.
+ */
+template <typename F>
+function_traits_result_type<F> call_from_yaml(F const& func, config_node const& config) {
+    using params_type = function_traits_params_type<F>;
+    params_type params;
+    yaml_to_tuple<params_type>::to_tuple(params, config);
+    return std::apply(func, std::move(params));
+}
+
+/**
+ * @brief Calls func with its only argument created from yaml, a YAML::Node or config_node.
+ */
+template <typename F, typename CT>
+function_traits_result_type<F> call_from_yaml_single(F const& func, CT const& yaml) {
+    using params_type = function_traits_params_type<F>;
+    params_type params;
+    tuple_element_from_yaml<params_type, 0>(params, yaml);
+    return std::apply(func, std::move(params));
+}
+
+/**
+ * @brief Calls func with arguments bound from the entries of map yaml, a YAML::Node or config_node, by plan.  Fields
+ * missing from the map are created from null, and only the first of duplicate keys is used, both matching
+ * yaml[field].
+ */
+template <typename F, typename CT>
+function_traits_result_type<F> call_from_yaml_map(F const& func, map_binding_plan const& plan, CT const& yaml,
+                                                  bool strictFields) {
+    using params_type = function_traits_params_type<F>;
+    constexpr std::size_t param_count = std::tuple_size<params_type>::value;
+    using index_sequence = std::make_index_sequence<param_count>;
+
+    params_type params;
+    std::array<bool, param_count> bound{};
+    if (yaml.IsMap()) {
+        for (auto const& entry : yaml) {
+            auto const& field = entry.first.Scalar();
+            std::size_t const index = plan.index_of(field);
+            if (index == map_binding_plan::npos) {
+                if (strictFields) {
+                    throw std::runtime_error("Unexpected field \"" + std::string(field) +
+                                             "\" found in yaml configuration. Valid fields are " +
+                                             plan.formatted_fields());
+                }
+                continue;
+            }
+            if (!bound[index]) {
+                bound[index] = true;
+                tuple_element_from_yaml(params, index, entry.second, index_sequence{});
+            }
+        }
+    } else if (yaml.IsDefined() && !yaml.IsNull()) {
+        throw std::runtime_error("Expected yaml map with fields " + plan.formatted_fields());
+    }
+
+    CT missing;
+    if constexpr (std::is_same<CT, config_node>::value) {
+        missing = config_node::null();
+    }
+    for (std::size_t index = 0; index < param_count; ++index) {
+        if (!bound[index]) {
+            tuple_element_from_yaml(params, index, missing, index_sequence{});
+        }
+    }
+
+    return std::apply(func, std::move(params));
+}
+
+/**
+ * @brief The initializer make_map_initializer returns, callable with a YAML::Node or config_node.
+ */
+template <typename BT, typename F>
+auto map_initializer(F func, std::vector<std::string> fields, bool strictFields) {
+    if (fields.size() != std::tuple_size<function_traits_params_type<F>>::value) {
+        throw std::runtime_error("Field count must match argument count");
+    }
+    for (auto field = fields.begin(); field != fields.end(); ++field) {
+        if (std::find(fields.begin(), field, *field) != field) {
+            throw std::runtime_error("Field \"" + *field + "\" is repeated in map initializer for \"" +
+                                     std::string(demangle_type<BT>()) + "\"");
+        }
+    }
+
+    // Compiled once and shared by copies of the initializer
+    std::shared_ptr<map_binding_plan const> plan(new map_binding_plan(std::move(fields)));
+    return [func, plan, strictFields](auto const& yaml) {
+        try {
+            return call_from_yaml_map(func, *plan, yaml, strictFields);
+        } catch (yadi_mapping_exception& ex) {
+            throw yadi_mapping_exception(ex.index, ex.msg, plan->fields()[ex.index]);
+        }
+    };
+}
 }  // namespace details
 // \endcond
 
@@ -419,6 +580,11 @@ T yaml_as(YAML::Node const& config) {
     return config.as<T>();
 }
 
+template <typename T>
+T config_as(config_node const& config) {
+    return config.as<T>();
+}
+
 template <typename T>
 initializer_type_t<T> make_yaml_as_initializer() {
     return &yaml_as<T>;
@@ -427,7 +593,8 @@ initializer_type_t<T> make_yaml_as_initializer() {
 template <typename T>
 yadi_info_t<T> make_yaml_as_initializer_with_help() {
     // TODO Improved error message
-    return {&yaml_as<T>, "Direct conversion using yaml.as<" + adapter<T>::get_name() + ">()"};
+    return {&yaml_as<T>, "Direct conversion using yaml.as<" + std::string(adapter<T>::get_name()) + ">()",
+            &config_as<T>};
 }
 
 template <typename BT, typename IT>
@@ -451,12 +618,7 @@ initializer_type_t<BT> make_single_arg_initializer(F func) {
         throw std::runtime_error("Single arg initializer must accept only a single argument");
     }
 
-    // Make sequence and call func
-    return [func](YAML::Node const& yaml) {
-        YAML::Node seq;
-        seq.push_back(yaml);
-        return details::call_from_yaml(func, seq);
-    };
+    return [func](YAML::Node const& yaml) { return details::call_from_yaml_single(func, yaml); };
 }
 
 template <typename BT, typename F>
@@ -470,7 +632,8 @@ yadi_info_t<BT> make_single_arg_initializer_with_help(F func, std::string help)
 
     help = "YAML configuration converted to single \"" + field_types.front() + "\": " + help;
 
-    return {make_single_arg_initializer<BT>(func), help};
+    return {make_single_arg_initializer<BT>(func), help,
+            [func](config_node const& config) { return details::call_from_yaml_single(func, config); }};
 }
 
 template <typename BT, typename F>
@@ -492,40 +655,13 @@ yadi_info_t<BT> make_sequence_initializer_with_help(F func, std::vector<std::str
             help += ", " + helps[i];
         }
     }
-    return {make_sequence_initializer<BT>(func), help};
+    return {make_sequence_initializer<BT>(func), help,
+            [func](config_node const& config) { return details::call_from_yaml(func, config); }};
 }
 
 template <typename BT, typename F>
 initializer_type_t<BT> make_map_initializer(F func, std::vector<std::string> fields, bool strictFields) {
-    return [func, fields, strictFields](YAML::Node const& yaml) {
-        if(strictFields) {
-            std::set<std::string> fieldSet{fields.begin(), fields.end()};
-            for(auto iter = yaml.begin(); iter != yaml.end(); ++iter) {
-                std::string value = iter->first.as<std::string>();
-                if(fieldSet.find(value) == fieldSet.end()) {
-                    throw std::runtime_error("Unexpected field \"" + value + "\" found in yaml configuration. Valid fields are " +
-                                                 formatFields(fields));
-                }
-            }
-        }
-        // Convert yaml map to sequence via ordered field list
-        // TODO error checking for yaml map type
-        YAML::Node sequence;
-        for (std::string const& field : fields) {
-            // TODO error checking for field
-            YAML::Node fieldNode = yaml[field];
-            if(fieldNode) {
-                sequence.push_back(fieldNode);
-            } else {
-                sequence.push_back(YAML::Null);
-            }
-        }
-        try {
-            return details::call_from_yaml(func, sequence);
-        } catch(details::yadi_mapping_exception & ex) {
-            throw details::yadi_mapping_exception(ex.index, ex.msg, fields[ex.index]);
-        }
-    };
+    return details::map_initializer<BT>(func, std::move(fields), strictFields);
 }
 
 template <typename BT, typename F>
@@ -570,31 +706,30 @@ yadi_info_t<BT> make_map_initializer_with_help(F func, std::vector<std::string>
             help += ", " + field_help;
         }
     }
-    return {make_map_initializer<BT>(func, fields, strictFields), help};
+    auto const initializer = details::map_initializer<BT>(func, fields, strictFields);
+    return {initializer, help, initializer};
 }
 
-// TODO thread safe
 template <typename BT>
 initializer_type_t<BT> make_caching_initializer(initializer_type_t<BT> const& initializing_initializer) {
     static_assert(std::is_same<ptr_type_t<BT>, std::shared_ptr<BT>>::value,
                   "ptr_type for BT must be shared_ptr to use caching initializer");
 
-    using Cache = std::map<std::string, std::weak_ptr<BT>>;
-    Cache cache;
-    auto caching_initializer = [cache, initializing_initializer](YAML::Node const& config) mutable -> ptr_type_t<BT> {
-        // TODO Apply formatting to yaml_key
-        std::string yaml_key = YAML::Dump(config);
-        typename Cache::iterator cache_it = cache.find(yaml_key);
-        if (cache_it != cache.end()) {
-            ptr_type_t<BT> instance = cache_it->second.lock();
-            if (instance) {
-                return instance;
-            }
+    // Shared so copies of the initializer use the same cache
+    using Cache = details::instance_cache<BT, details::hashed_yaml, details::hashed_yaml_hash,
+                                          details::hashed_yaml_equal>;
+    std::shared_ptr<Cache> cache(new Cache());
+    auto caching_initializer = [cache, initializing_initializer](YAML::Node const& config) -> ptr_type_t<BT> {
+        details::hashed_yaml const yaml_key(config);
+        if (ptr_type_t<BT> instance = cache->find(yaml_key)) {
+            return instance;
         }
 
-        ptr_type_t<BT> new_instance = initializing_initializer(config);
-        cache[yaml_key] = new_instance;
-        return new_instance;
+        // The stored key is cloned so later changes to the caller's config can't alter it
+        details::hashed_yaml const stored_key(yaml_key.hash, config.IsDefined() ? YAML::Clone(config) : config);
+        return cache->get_or_create(stored_key, [&initializing_initializer, &config]() {
+            return initializing_initializer(config);
+        });
     };
 
     return caching_initializer;
@@ -603,6 +738,8 @@ initializer_type_t<BT> make_caching_initializer(initializer_type_t<BT> const& in
 template <typename BT>
 yadi_info_t<BT> make_caching_initializer(yadi_info_t<BT> yi) {
     yi.initializer = make_caching_initializer<BT>(yi.initializer);
+    // Nodes are converted to YAML so they go through the cache
+    yi.config_initializer = nullptr;
     return yi;
 }
 
@@ -0,0 +1,211 @@
+#ifndef YADI_INLINE_FUNCTION_HPP
+#define YADI_INLINE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+// \cond DEV_DOCS
+namespace details {
+
+template <typename SIG, std::size_t CAPACITY = 48>
+class inline_function;
+
+/**
+ * @brief Whether F is a function wrapper which may be empty, such as std::function.  An empty one is stored as
+ * nothing, as std::function does.
+ */
+template <typename F>
+struct is_function_wrapper : std::false_type {};
+
+template <typename SIG>
+struct is_function_wrapper<std::function<SIG>> : std::true_type {};
+
+template <typename SIG, std::size_t CAPACITY>
+struct is_function_wrapper<inline_function<SIG, CAPACITY>> : std::true_type {};
+
+/**
+ * @brief Type erased callable like std::function, for factory initializers.  Callables up to CAPACITY bytes are stored
+ * inline and anything larger is allocated once on construction, calling is a single indirect call either way.  The
+ * stored type is identified by its manager function rather than RTTI.
+ * @tparam R Result type
+ * @tparam ARGS Argument types
+ * @tparam CAPACITY Bytes stored inline
+ */
+template <typename R, typename... ARGS, std::size_t CAPACITY>
+class inline_function<R(ARGS...), CAPACITY> {
+   public:
+    inline_function() noexcept = default;
+
+    inline_function(std::nullptr_t) noexcept {}
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, inline_function>::value &&
+                                                      std::is_invocable_r<R, std::decay_t<F>&, ARGS...>::value>>
+    inline_function(F&& func) {
+        using callable_type = std::decay_t<F>;
+        if constexpr (std::is_pointer<callable_type>::value || std::is_member_pointer<callable_type>::value ||
+                      is_function_wrapper<callable_type>::value) {
+            if (!func) {
+                return;
+            }
+        }
+        if constexpr (stored_inline<callable_type>()) {
+            new (&this->buffer) callable_type(std::forward<F>(func));
+            this->invoker = &invoke_inline<callable_type>;
+        } else {
+            *reinterpret_cast<callable_type**>(&this->buffer) = new callable_type(std::forward<F>(func));
+            this->invoker = &invoke_heap<callable_type>;
+        }
+        this->manager = &manage<callable_type>;
+    }
+
+    inline_function(inline_function const& other) : invoker(other.invoker), manager(other.manager) {
+        if (this->manager) {
+            this->manager(operation::copy, &other.buffer, &this->buffer);
+        }
+    }
+
+    inline_function(inline_function&& other) noexcept : invoker(other.invoker), manager(other.manager) {
+        if (this->manager) {
+            this->manager(operation::move, &other.buffer, &this->buffer);
+            other.invoker = nullptr;
+            other.manager = nullptr;
+        }
+    }
+
+    ~inline_function() { this->reset(); }
+
+    inline_function& operator=(inline_function const& other) {
+        if (this != &other) {
+            inline_function copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    inline_function& operator=(inline_function&& other) noexcept {
+        if (this != &other) {
+            this->reset();
+            if (other.manager) {
+                other.manager(operation::move, &other.buffer, &this->buffer);
+                this->invoker = std::exchange(other.invoker, nullptr);
+                this->manager = std::exchange(other.manager, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    inline_function& operator=(std::nullptr_t) noexcept {
+        this->reset();
+        return *this;
+    }
+
+    explicit operator bool() const noexcept { return this->invoker != nullptr; }
+
+    /**
+     * @brief The stored callable if it's an F, see std::function::target.
+     */
+    template <typename F>
+    F const* target() const noexcept {
+        if (this->manager != &manage<F>) {
+            return nullptr;
+        }
+        if constexpr (stored_inline<F>()) {
+            return std::launder(reinterpret_cast<F const*>(&this->buffer));
+        } else {
+            return *reinterpret_cast<F const* const*>(&this->buffer);
+        }
+    }
+
+    /**
+     * @throws std::bad_function_call if empty
+     */
+    R operator()(ARGS... args) const {
+        if (!this->invoker) {
+            throw std::bad_function_call();
+        }
+        // Like std::function the callable is called as non-const
+        return this->invoker(const_cast<storage*>(&this->buffer), std::forward<ARGS>(args)...);
+    }
+
+   private:
+    using storage = std::aligned_storage_t<CAPACITY, alignof(std::max_align_t)>;
+
+    enum class operation { copy, move, destroy };
+
+    template <typename F>
+    static constexpr bool stored_inline() {
+        return sizeof(F) <= CAPACITY && alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+    template <typename F>
+    static R invoke_inline(storage* buffer, ARGS&&... args) {
+        return std::invoke(*std::launder(reinterpret_cast<F*>(buffer)), std::forward<ARGS>(args)...);
+    }
+
+    template <typename F>
+    static R invoke_heap(storage* buffer, ARGS&&... args) {
+        return std::invoke(**reinterpret_cast<F**>(buffer), std::forward<ARGS>(args)...);
+    }
+
+    // Moving never throws, a heap callable just moves its pointer
+    template <typename F>
+    static void manage(operation op, storage const* from, storage* to) {
+        if constexpr (stored_inline<F>()) {
+            F* source = std::launder(reinterpret_cast<F*>(const_cast<storage*>(from)));
+            switch (op) {
+                case operation::copy:
+                    new (to) F(*source);
+                    break;
+                case operation::move:
+                    new (to) F(std::move(*source));
+                    source->~F();
+                    break;
+                case operation::destroy:
+                    source->~F();
+                    break;
+            }
+        } else {
+            F* source = *reinterpret_cast<F* const*>(from);
+            switch (op) {
+                case operation::copy:
+                    *reinterpret_cast<F**>(to) = new F(*source);
+                    break;
+                case operation::move:
+                    *reinterpret_cast<F**>(to) = source;
+                    break;
+                case operation::destroy:
+                    delete source;
+                    break;
+            }
+        }
+    }
+
+    void reset() noexcept {
+        if (this->manager) {
+            this->manager(operation::destroy, &this->buffer, nullptr);
+            this->invoker = nullptr;
+            this->manager = nullptr;
+        }
+    }
+
+    storage buffer;
+    R (*invoker)(storage*, ARGS&&...) = nullptr;
+    void (*manager)(operation, storage const*, storage*) = nullptr;
+};
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
+
+#endif  // YADI_INLINE_FUNCTION_HPP
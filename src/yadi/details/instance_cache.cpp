@@ -0,0 +1 @@
+#include "instance_cache.hpp"
@@ -0,0 +1,197 @@
+#ifndef YADI_INSTANCE_CACHE_HPP
+#define YADI_INSTANCE_CACHE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief Thread safe cache of weak pointers to shared instances.  Keys are spread over independently locked shards,
+ * and concurrent misses for the same key construct a single instance which every caller receives.  Expired entries are
+ * swept from a shard as it grows so the cache is bounded by the number of live instances.
+ * @tparam T Instance type
+ * @tparam Key
+ * @tparam Hash
+ * @tparam KeyEqual
+ */
+template <typename T, typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class instance_cache {
+   public:
+    using instance_type = std::shared_ptr<T>;
+
+    explicit instance_cache(std::size_t shard_count = 16) : shards(shard_count) {}
+
+    instance_cache(instance_cache const&) = delete;
+    instance_cache& operator=(instance_cache const&) = delete;
+
+    /**
+     * @brief Returns the live instance cached for key.
+     * @param key
+     * @return The instance or nullptr if there isn't one, including while it's being created.
+     */
+    instance_type find(Key const& key) const;
+
+    /**
+     * @brief Returns the live instance cached for key, otherwise calls create and caches the result.  Callers missing on
+     * a key another thread is creating wait for and share that instance.  The lock is not held while creating.
+     * @tparam F
+     * @param key
+     * @param create
+     * @return
+     * @throws Whatever create throws, also to callers waiting on the same creation
+     */
+    template <typename F>
+    instance_type get_or_create(Key const& key, F&& create);
+
+    /**
+     * @brief Removes expired entries from every shard.
+     */
+    void purge();
+
+    /**
+     * @brief Number of entries, including expired entries not yet swept.
+     * @return
+     */
+    std::size_t size() const;
+
+   private:
+    static constexpr std::size_t MIN_PURGE_THRESHOLD = 16;
+
+    struct entry {
+        std::weak_ptr<T> instance;
+        std::shared_future<instance_type> pending;  ///< Valid while the instance is being created.
+    };
+
+    struct shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, entry, Hash, KeyEqual> entries;
+        std::size_t purge_threshold = MIN_PURGE_THRESHOLD;
+    };
+
+    shard& shard_for(Key const& key) { return this->shards[Hash{}(key) % this->shards.size()]; }
+
+    shard const& shard_for(Key const& key) const { return this->shards[Hash{}(key) % this->shards.size()]; }
+
+    static void purge(shard& s);
+
+    std::vector<shard> shards;
+};
+
+// ################### IMPL ######################
+
+template <typename T, typename Key, typename Hash, typename KeyEqual>
+typename instance_cache<T, Key, Hash, KeyEqual>::instance_type instance_cache<T, Key, Hash, KeyEqual>::find(
+    Key const& key) const {
+    shard const& s = this->shard_for(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto entry_iter = s.entries.find(key);
+    return entry_iter == s.entries.end() ? nullptr : entry_iter->second.instance.lock();
+}
+
+template <typename T, typename Key, typename Hash, typename KeyEqual>
+template <typename F>
+typename instance_cache<T, Key, Hash, KeyEqual>::instance_type instance_cache<T, Key, Hash, KeyEqual>::get_or_create(
+    Key const& key, F&& create) {
+    shard& s = this->shard_for(key);
+    std::promise<instance_type> promise;
+    std::shared_future<instance_type> pending;
+    entry* created = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto entry_iter = s.entries.find(key);
+        if (entry_iter != s.entries.end()) {
+            if (entry_iter->second.pending.valid()) {
+                pending = entry_iter->second.pending;
+            } else if (instance_type instance = entry_iter->second.instance.lock()) {
+                return instance;
+            }
+        }
+
+        if (!pending.valid()) {
+            if (entry_iter == s.entries.end()) {
+                if (s.entries.size() >= s.purge_threshold) {
+                    purge(s);
+                }
+                entry_iter = s.entries.emplace(key, entry{}).first;
+            }
+            // Element references survive rehashing and only this caller erases a pending entry
+            created = &entry_iter->second;
+            created->pending = promise.get_future().share();
+        }
+    }
+
+    if (!created) {
+        return pending.get();
+    }
+
+    instance_type instance;
+    try {
+        instance = create();
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.entries.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        created->instance = instance;
+        created->pending = {};
+    }
+    promise.set_value(instance);
+    return instance;
+}
+
+template <typename T, typename Key, typename Hash, typename KeyEqual>
+void instance_cache<T, Key, Hash, KeyEqual>::purge() {
+    for (shard& s : this->shards) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        purge(s);
+    }
+}
+
+template <typename T, typename Key, typename Hash, typename KeyEqual>
+void instance_cache<T, Key, Hash, KeyEqual>::purge(shard& s) {
+    for (auto entry_iter = s.entries.begin(); entry_iter != s.entries.end();) {
+        if (!entry_iter->second.pending.valid() && entry_iter->second.instance.expired()) {
+            entry_iter = s.entries.erase(entry_iter);
+        } else {
+            ++entry_iter;
+        }
+    }
+    // Sweep again once the live entries have doubled, keeping the cost per insert constant
+    s.purge_threshold = std::max(MIN_PURGE_THRESHOLD, s.entries.size() * 2);
+}
+
+template <typename T, typename Key, typename Hash, typename KeyEqual>
+std::size_t instance_cache<T, Key, Hash, KeyEqual>::size() const {
+    std::size_t ret = 0;
+    for (shard const& s : this->shards) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        ret += s.entries.size();
+    }
+    return ret;
+}
+
+}  // namespace details
+// \endcond
+}  // namespace yadi
+
+#endif  // YADI_INSTANCE_CACHE_HPP
@@ -0,0 +1,25 @@
+#include "json.hpp"
+
+#include <cstdio>
+
+namespace yadi {
+
+std::string details::json_string(std::string_view str) {
+    std::string out = "\"";
+    out.reserve(str.size() + 2);
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out += '"';
+}
+
+}  // namespace yadi
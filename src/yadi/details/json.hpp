@@ -0,0 +1,29 @@
+#ifndef YADI_JSON_HPP
+#define YADI_JSON_HPP
+
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief str as a quoted JSON string.  Quotes, backslashes and control characters are escaped, other bytes are
+ * written as they are.
+ * @param str
+ * @return
+ */
+std::string json_string(std::string_view str);
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
+
+#endif  // YADI_JSON_HPP
@@ -0,0 +1,169 @@
+#include "layered_config.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace yadi {
+
+namespace {
+
+bool is_set(YAML::Node const& yaml) { return yaml.IsDefined() && !yaml.IsNull(); }
+
+std::string const& type_name(YAML::Node const& yaml) {
+    static std::string const YAML_TYPE_NAMES[] = {"Undefined", "Null", "Scalar", "Sequence", "Map"};
+    return YAML_TYPE_NAMES[yaml.IsDefined() ? yaml.Type() : YAML::NodeType::Undefined];
+}
+
+}  // anonymous namespace
+
+/**
+ * @brief The layers showing through under one key, gathered from the highest layer down.
+ */
+struct layered_config::key_values {
+    explicit key_values(merge_mode mode) { this->view.merge = mode; }
+
+    /**
+     * @brief Adds the value of the key in layer, the first one seen in each layer counts.  Only maps show through the
+     * map above them, anything else is hidden along with the layers below.
+     */
+    void add(std::size_t layer, YAML::Node const& value) {
+        if (!this->open || (!this->view.layers.empty() && layer == this->last)) {
+            return;
+        }
+        if (!this->view.layers.empty() && !value.IsMap()) {
+            this->open = false;
+            return;
+        }
+        this->view.layers.push_back(value);
+        this->last = layer;
+        this->open = this->view.merge == merge_mode::deep && value.IsMap();
+    }
+
+    layered_config view;
+    std::size_t last = 0;  ///< Layer of the last value added
+    bool open = true;      ///< Whether lower layers may still show through
+};
+
+layered_config::layered_config(YAML::Node config, merge_mode mode) : layers{std::move(config)}, merge(mode) {}
+
+layered_config& layered_config::under(YAML::Node defaults) {
+    this->layers.push_back(std::move(defaults));
+    return *this;
+}
+
+layered_config layered_config::operator[](std::string_view key) const {
+    key_values value(this->merge);
+    for (std::size_t i = 0; i < this->layers.size(); ++i) {
+        YAML::Node const& layer = this->layers[i];
+        if (!is_set(layer)) {
+            continue;
+        }
+        if (!layer.IsMap()) {
+            break;
+        }
+        for (auto const& entry : layer) {
+            if (entry.first.IsScalar() && entry.first.Scalar() == key) {
+                value.add(i, entry.second);
+                break;
+            }
+        }
+        // A value which isn't a map hides everything below, and in shallow mode so does any value
+        if (!value.open) {
+            break;
+        }
+    }
+    return std::move(value.view);
+}
+
+bool layered_config::defined() const {
+    for (YAML::Node const& layer : this->layers) {
+        if (is_set(layer)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+YAML::Node layered_config::node() const { return this->materialize(false); }
+
+YAML::Node layered_config::materialize(bool copy) const {
+    std::vector<YAML::Node const*> visible;
+    for (YAML::Node const& layer : this->layers) {
+        if (is_set(layer)) {
+            visible.push_back(&layer);
+        }
+    }
+
+    // Nothing to merge, the config is used as is
+    if (visible.empty()) {
+        if (this->layers.empty()) {
+            return YAML::Node();
+        }
+        return copy ? YAML::Clone(this->layers.back()) : this->layers.back();
+    }
+    if (visible.size() == 1) {
+        return copy ? YAML::Clone(*visible.front()) : *visible.front();
+    }
+
+    for (std::size_t i = 1; i < visible.size(); ++i) {
+        if (!visible[i - 1]->IsMap() || !visible[i]->IsMap()) {
+            throw std::runtime_error("Unable to merge YAML types " + type_name(*visible[i]) + " and " +
+                                     type_name(*visible[i - 1]));
+        }
+    }
+
+    // Entries are copied once, from the highest layer defining them.  They can't be shared instead, inserting a node
+    // from another document into merged would tie the documents' memory together for good.  In shallow mode the top
+    // layer is copied whole, which is cheaper than entry by entry.  Each layer is walked once, gathering the maps under
+    // every key across layers as it goes, so they are merged without looking the key up again.
+    bool const shallow = this->merge == merge_mode::shallow;
+    std::size_t const NO_GROUP = static_cast<std::size_t>(-1);
+    struct pending_entry {
+        YAML::Node key;
+        YAML::Node value;
+        std::size_t group;  ///< Index into groups if the value is merged, otherwise NO_GROUP
+    };
+    std::vector<pending_entry> entries;
+    std::vector<key_values> groups;
+    std::vector<std::size_t> first_layer;                   ///< Layer where each group's key was first seen
+    std::unordered_map<std::string_view, std::size_t> keys;  ///< Key to its index in groups
+    for (std::size_t i = 0; i < visible.size(); ++i) {
+        bool const emit = !shallow || i != 0;
+        for (auto const& entry : *visible[i]) {
+            if (!entry.first.IsScalar()) {
+                if (emit) {
+                    entries.push_back({entry.first, entry.second, NO_GROUP});
+                }
+                continue;
+            }
+            auto const found = keys.emplace(entry.first.Scalar(), groups.size());
+            if (found.second) {
+                groups.emplace_back(this->merge);
+                first_layer.push_back(i);
+            } else if (first_layer[found.first->second] != i) {
+                // Seen in a layer above
+                groups[found.first->second].add(i, entry.second);
+                continue;
+            }
+            key_values& group = groups[found.first->second];
+            group.add(i, entry.second);
+            if (emit) {
+                bool const merged = !shallow && entry.second.IsMap();
+                entries.push_back({entry.first, entry.second, merged ? found.first->second : NO_GROUP});
+            }
+        }
+    }
+
+    YAML::Node merged = shallow ? YAML::Clone(*visible.front()) : YAML::Node(YAML::NodeType::Map);
+    for (pending_entry const& entry : entries) {
+        if (entry.group != NO_GROUP) {
+            merged.force_insert(YAML::Clone(entry.key), groups[entry.group].view.materialize(true));
+        } else {
+            merged.force_insert(YAML::Clone(entry.key), YAML::Clone(entry.value));
+        }
+    }
+    return merged;
+}
+
+}  // namespace yadi
@@ -0,0 +1,87 @@
+#ifndef YADI_LAYERED_CONFIG_HPP
+#define YADI_LAYERED_CONFIG_HPP
+
+#include <yaml-cpp/yaml.h>
+
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief How maps in different layers combine.
+ */
+enum class merge_mode {
+    shallow,  ///< A key in a higher layer hides the key in lower layers
+    deep      ///< Maps under the same key are merged recursively
+};
+
+/**
+ * @brief Read-only view of configs stacked in layers, for example defaults under a passed config.  Lookups fall
+ * through from the top layer to lower ones without copying any layer.  node() materializes a real YAML::Node, which
+ * is the top layer itself when no other layer shows through, and otherwise a merged copy of only the visible entries,
+ * lower layers included.
+ */
+class layered_config {
+   public:
+    layered_config() = default;
+
+    explicit layered_config(YAML::Node config, merge_mode mode = merge_mode::shallow);
+
+    /**
+     * @brief Adds defaults as the lowest priority layer.
+     * @param defaults
+     * @return *this
+     */
+    layered_config& under(YAML::Node defaults);
+
+    /**
+     * @brief The value of key from the highest layer defining it.  In deep mode maps under key in lower layers show
+     * through a map above them, down to the first layer where key isn't a map, which is hidden with those below.
+     * @param key
+     * @return The view of the value, which is undefined if no layer defines key.
+     */
+    layered_config operator[](std::string_view key) const;
+
+    /**
+     * @brief Whether any layer is defined and not null.
+     * @return
+     */
+    bool defined() const;
+
+    merge_mode mode() const { return this->merge; }
+
+    /**
+     * @brief Materializes the view.  If both of two visible layers aren't maps they can't be merged.
+     * @return
+     * @throws std::runtime_error if the visible layers can't be merged
+     */
+    YAML::Node node() const;
+
+    /**
+     * @brief Equivalent to node().as<T>().
+     */
+    template <typename T>
+    T as() const {
+        return this->node().template as<T>();
+    }
+
+   private:
+    struct key_values;
+
+    /**
+     * @brief See node().  With copy the result never refers to a layer, so it can be inserted into another document.
+     */
+    YAML::Node materialize(bool copy) const;
+
+    std::vector<YAML::Node> layers;  ///< Highest priority first
+    merge_mode merge = merge_mode::shallow;
+};
+
+}  // namespace yadi
+
+#endif  // YADI_LAYERED_CONFIG_HPP
@@ -0,0 +1,254 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+namespace yadi {
+
+namespace {
+
+/**
+ * @brief Counters of one slot on one thread.  Only the owning thread writes them, so an increment is a relaxed load
+ * and store rather than a locked add, and snapshots read them while they're written.
+ */
+struct slot_counters {
+    std::atomic<std::uint64_t> creates{0};
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::array<std::atomic<std::uint64_t>, LATENCY_BUCKETS> latency{};
+};
+
+constexpr std::size_t CHUNK_SLOTS = 64;
+
+using counter_chunk = std::array<slot_counters, CHUNK_SLOTS>;
+
+void add(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+std::size_t latency_bucket(std::uint64_t nanoseconds) {
+    if (nanoseconds < 2) {
+        return 0;
+    }
+#if defined(__GNUC__)
+    std::size_t const bucket = 63 - __builtin_clzll(nanoseconds);
+#else
+    std::size_t bucket = 0;
+    while (nanoseconds >>= 1) {
+        ++bucket;
+    }
+#endif
+    return bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1;
+}
+
+void accumulate(create_metrics& total, slot_counters const& counters) {
+    total.creates += counters.creates.load(std::memory_order_relaxed);
+    total.failures += counters.failures.load(std::memory_order_relaxed);
+    total.nanoseconds += counters.nanoseconds.load(std::memory_order_relaxed);
+    total.bytes += counters.bytes.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        total.latency[i] += counters.latency[i].load(std::memory_order_relaxed);
+    }
+}
+
+void accumulate(create_metrics& total, create_metrics const& other) {
+    total.creates += other.creates;
+    total.failures += other.failures;
+    total.nanoseconds += other.nanoseconds;
+    total.bytes += other.bytes;
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        total.latency[i] += other.latency[i];
+    }
+}
+
+void subtract(create_metrics& total, create_metrics const& baseline) {
+    total.creates -= baseline.creates;
+    total.failures -= baseline.failures;
+    total.nanoseconds -= baseline.nanoseconds;
+    total.bytes -= baseline.bytes;
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        total.latency[i] -= baseline.latency[i];
+    }
+}
+
+struct thread_counters;
+
+struct metrics_registry {
+    std::mutex mutex;
+    std::map<std::pair<std::string, std::string>, std::size_t> slots;
+    std::vector<std::pair<std::string, std::string>> names;  ///< Indexed by slot
+    std::vector<thread_counters*> threads;
+    std::vector<create_metrics> retired;   ///< Counts of exited threads, indexed by slot
+    std::vector<create_metrics> baseline;  ///< Totals when last reset, indexed by slot
+};
+
+metrics_registry& registry() {
+    // Never destroyed, threads may exit during static destruction
+    static metrics_registry* metrics = new metrics_registry();
+    return *metrics;
+}
+
+/**
+ * @brief Counters of every slot on one thread, in chunks so they never move.  The owning thread takes mutex only to
+ * add chunks, snapshots take it to read them.
+ */
+struct thread_counters : public details::thread_create_state {
+    thread_counters() {
+        metrics_registry& metrics = registry();
+        std::lock_guard<std::mutex> lock(metrics.mutex);
+        metrics.threads.push_back(this);
+    }
+
+    ~thread_counters() {
+        metrics_registry& metrics = registry();
+        std::lock_guard<std::mutex> lock(metrics.mutex);
+        metrics.threads.erase(std::find(metrics.threads.begin(), metrics.threads.end(), this));
+        this->add_to(metrics.retired);
+    }
+
+    slot_counters& at(std::size_t slot) {
+        std::size_t const chunk = slot / CHUNK_SLOTS;
+        if (chunk >= this->chunks.size()) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            while (chunk >= this->chunks.size()) {
+                this->chunks.emplace_back(new counter_chunk());
+            }
+        }
+        return (*this->chunks[chunk])[slot % CHUNK_SLOTS];
+    }
+
+    /**
+     * @brief Adds every slot to totals, which must have an entry for each slot.
+     */
+    void add_to(std::vector<create_metrics>& totals) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        for (std::size_t slot = 0; slot < totals.size() && slot / CHUNK_SLOTS < this->chunks.size(); ++slot) {
+            accumulate(totals[slot], (*this->chunks[slot / CHUNK_SLOTS])[slot % CHUNK_SLOTS]);
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<counter_chunk>> chunks;
+};
+
+// A plain pointer is read without the guard a thread_local with a constructor needs
+thread_local thread_counters* LOCAL_COUNTERS = nullptr;
+
+thread_counters& local_counters() {
+    if (!LOCAL_COUNTERS) {
+        thread_local thread_counters counters;
+        LOCAL_COUNTERS = &counters;
+    }
+    return *LOCAL_COUNTERS;
+}
+
+/**
+ * @brief Every slot summed over live and exited threads.  Expects the registry mutex to be held.
+ */
+std::vector<create_metrics> totals(metrics_registry& metrics) {
+    std::vector<create_metrics> sums(metrics.names.size());
+    for (std::size_t slot = 0; slot < sums.size(); ++slot) {
+        sums[slot].factory = metrics.names[slot].first;
+        sums[slot].type = metrics.names[slot].second;
+    }
+    for (thread_counters* counters : metrics.threads) {
+        counters->add_to(sums);
+    }
+    for (std::size_t slot = 0; slot < metrics.retired.size(); ++slot) {
+        accumulate(sums[slot], metrics.retired[slot]);
+    }
+    return sums;
+}
+
+}  // anonymous namespace
+
+std::uint64_t create_metrics::latency_percentile(double fraction) const {
+    std::uint64_t count = 0;
+    for (std::uint64_t bucket : this->latency) {
+        count += bucket;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    std::uint64_t const target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * count + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += this->latency[i];
+        if (seen >= target) {
+            return std::uint64_t(2) << i;
+        }
+    }
+    return std::uint64_t(2) << (LATENCY_BUCKETS - 1);
+}
+
+std::vector<create_metrics> create_metrics_snapshot() {
+    metrics_registry& metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    std::vector<create_metrics> sums = totals(metrics);
+    for (std::size_t slot = 0; slot < metrics.baseline.size(); ++slot) {
+        subtract(sums[slot], metrics.baseline[slot]);
+    }
+    std::sort(sums.begin(), sums.end(), [](create_metrics const& left, create_metrics const& right) {
+        return std::tie(left.factory, left.type) < std::tie(right.factory, right.type);
+    });
+    return sums;
+}
+
+void reset_create_metrics() {
+    // Counters are only written by their thread, so a reset subtracts the totals rather than zeroing them
+    metrics_registry& metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    metrics.baseline = totals(metrics);
+}
+
+void record_allocation(std::size_t bytes) {
+#ifdef YADI_INSTRUMENT
+    local_counters().allocated += bytes;
+#else
+    (void)bytes;
+#endif
+}
+
+// \cond DEV_DOCS
+namespace details {
+
+std::size_t create_metrics_slot(std::string_view factory, std::string_view type) {
+    metrics_registry& metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    auto const found = metrics.slots.find(std::make_pair(std::string(factory), std::string(type)));
+    if (found != metrics.slots.end()) {
+        return found->second;
+    }
+
+    std::size_t const slot = metrics.names.size();
+    metrics.names.emplace_back(std::string(factory), std::string(type));
+    metrics.slots.emplace(metrics.names.back(), slot);
+    metrics.retired.resize(metrics.names.size());
+    return slot;
+}
+
+thread_create_state& local_create_state() { return local_counters(); }
+
+void record_create(thread_create_state& state, std::size_t slot, std::uint64_t nanoseconds, std::uint64_t bytes,
+                   bool failed) {
+    slot_counters& counters = static_cast<thread_counters&>(state).at(slot);
+    add(counters.creates, 1);
+    if (failed) {
+        add(counters.failures, 1);
+    }
+    add(counters.nanoseconds, nanoseconds);
+    add(counters.bytes, bytes);
+    add(counters.latency[latency_bucket(nanoseconds)], 1);
+}
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
@@ -0,0 +1,136 @@
+#ifndef YADI_METRICS_HPP
+#define YADI_METRICS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Whether creates are instrumented, which is when YADI_INSTRUMENT is defined.  Without it the instrumentation
+ * compiles out of create and create_metrics_snapshot is always empty.  YADI_INSTRUMENT must be the same for the library
+ * and everything using it, the CMake option YADI_INSTRUMENT defines it for both.
+ */
+#ifdef YADI_INSTRUMENT
+inline constexpr bool instrumented = true;
+#else
+inline constexpr bool instrumented = false;
+#endif
+
+/// Number of latency buckets.  Bucket i counts creates taking less than 2^(i+1) ns and at least 2^i ns, the last
+/// bucket also counts anything slower.
+inline constexpr std::size_t LATENCY_BUCKETS = 32;
+
+/**
+ * @brief Creates of one type of one factory, counted from every thread.  Nested creates count toward both the outer
+ * and inner type.
+ */
+struct create_metrics {
+    std::string factory;           ///< Demangled base type
+    std::string type;              ///< Registered type name
+    std::uint64_t creates = 0;     ///< Calls to the initializer, including failures
+    std::uint64_t failures = 0;    ///< Calls that threw
+    std::uint64_t nanoseconds = 0; ///< Total time in the initializer
+    std::uint64_t bytes = 0;       ///< Bytes allocated while creating, see record_allocation
+    std::array<std::uint64_t, LATENCY_BUCKETS> latency{};
+
+    /**
+     * @brief Upper bound of the latency of the given fraction of creates, from the histogram.
+     * @param fraction Between 0 and 1, 0.99 for the 99th percentile
+     * @return Nanoseconds, 0 if there were no creates
+     */
+    std::uint64_t latency_percentile(double fraction) const;
+};
+
+/**
+ * @brief Metrics of every instrumented type that has been registered, ordered by factory and type.  Counters are
+ * kept per thread and summed here, counts of threads that have exited are kept.
+ * @return
+ */
+std::vector<create_metrics> create_metrics_snapshot();
+
+/**
+ * @brief Starts counting again from zero.
+ */
+void reset_create_metrics();
+
+/**
+ * @brief Counts bytes toward the creates in progress on this thread.  The allocation policies record the objects
+ * they allocate, this is for memory initializers allocate some other way, such as from their own allocator.  Does
+ * nothing without YADI_INSTRUMENT.
+ * @param bytes
+ */
+void record_allocation(std::size_t bytes);
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief Slot the metrics of type in factory are counted in.  The same names always get the same slot.
+ */
+std::size_t create_metrics_slot(std::string_view factory, std::string_view type);
+
+/**
+ * @brief Instrumentation state of one thread.
+ */
+struct thread_create_state {
+    std::uint64_t allocated = 0;  ///< Bytes recorded on the thread so far
+};
+
+thread_create_state& local_create_state();
+
+void record_create(thread_create_state& state, std::size_t slot, std::uint64_t nanoseconds, std::uint64_t bytes,
+                   bool failed);
+
+/**
+ * @brief Times a create from construction to destruction and counts it to slot.
+ */
+class create_timer {
+   public:
+    explicit create_timer(std::size_t slot)
+        : state(local_create_state()),
+          slot(slot),
+          exceptions(std::uncaught_exceptions()),
+          bytes(state.allocated),
+          start(std::chrono::steady_clock::now()) {}
+
+    ~create_timer() {
+        std::chrono::steady_clock::duration const elapsed = std::chrono::steady_clock::now() - this->start;
+        record_create(this->state, this->slot, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                      this->state.allocated - this->bytes,
+                      this->failed || std::uncaught_exceptions() > this->exceptions);
+    }
+
+    create_timer(create_timer const&) = delete;
+    create_timer& operator=(create_timer const&) = delete;
+
+    /**
+     * @brief Counts the create as failed, for failures that are caught before the timer is destroyed.
+     */
+    void fail() { this->failed = true; }
+
+   private:
+    thread_create_state& state;
+    std::size_t slot;
+    int exceptions;
+    bool failed = false;
+    std::uint64_t bytes;
+    std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
+
+#endif  // YADI_METRICS_HPP
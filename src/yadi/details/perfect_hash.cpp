@@ -0,0 +1,114 @@
+#include "perfect_hash.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace yadi {
+namespace details {
+
+namespace {
+
+std::uint64_t next_power_of_two(std::uint64_t value) {
+    std::uint64_t ret = 1;
+    while (ret < value) {
+        ret <<= 1;
+    }
+    return ret;
+}
+
+// Displacements tried per bucket before the table is grown and the build restarted
+constexpr std::uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+}  // anonymous namespace
+
+std::uint64_t hash_string(std::string_view str, std::uint64_t seed) {
+    std::uint64_t hash = 0xCBF29CE484222325ull ^ (seed * 0x100000001B3ull);
+    for (char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+perfect_hash::perfect_hash() : salt(0), bucket_mask(0), slot_mask(0), displacements(1, 0) {}
+
+perfect_hash::perfect_hash(std::vector<std::string_view> const& keys) : salt(0) {
+    std::uint64_t const key_count = std::max<std::uint64_t>(keys.size(), 1);
+    this->bucket_mask = next_power_of_two((key_count + 3) / 4) - 1;
+    this->slot_mask = next_power_of_two(key_count) - 1;
+
+    // Each attempt changes the hash function, larger tables are used after repeated failures
+    for (std::uint64_t attempt = 0; attempt < 64; ++attempt) {
+        this->salt = attempt;
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(keys.size());
+        for (std::string_view key : keys) {
+            hashes.push_back(this->key_hash(key));
+        }
+
+        if (this->build(hashes)) {
+            return;
+        }
+
+        if (attempt % 4 == 3) {
+            this->slot_mask = (this->slot_mask << 1) | 1;
+        }
+    }
+
+    throw std::runtime_error("Unable to build perfect hash, are the keys unique?");
+}
+
+bool perfect_hash::build(std::vector<std::uint64_t> const& hashes) {
+    std::vector<std::vector<std::uint64_t>> buckets(this->bucket_mask + 1);
+    for (std::uint64_t hash : hashes) {
+        buckets[hash & this->bucket_mask].push_back(hash);
+    }
+
+    // Place the largest buckets first while the table is mostly empty
+    std::vector<std::size_t> order(buckets.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&buckets](std::size_t l, std::size_t r) { return buckets[l].size() > buckets[r].size(); });
+
+    this->displacements.assign(buckets.size(), 0);
+    std::vector<bool> taken(this->slot_mask + 1, false);
+    std::vector<std::uint64_t> bucket_slots;
+    for (std::size_t bucket_index : order) {
+        std::vector<std::uint64_t> const& bucket = buckets[bucket_index];
+        if (bucket.empty()) {
+            break;
+        }
+
+        bool placed = false;
+        for (std::uint32_t displacement = 0; displacement < MAX_DISPLACEMENT && !placed; ++displacement) {
+            bucket_slots.clear();
+            placed = true;
+            for (std::uint64_t hash : bucket) {
+                std::uint64_t const slot = mix(hash, displacement) & this->slot_mask;
+                if (taken[slot] || std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()) {
+                    placed = false;
+                    break;
+                }
+                bucket_slots.push_back(slot);
+            }
+
+            if (placed) {
+                this->displacements[bucket_index] = displacement;
+                for (std::uint64_t slot : bucket_slots) {
+                    taken[slot] = true;
+                }
+            }
+        }
+
+        if (!placed) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace details
+}  // namespace yadi
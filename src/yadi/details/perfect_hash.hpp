@@ -0,0 +1,129 @@
+#ifndef YADI_PERFECT_HASH_HPP
+#define YADI_PERFECT_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief FNV-1a hash of a string.
+ * @param str
+ * @param seed Mixed into the offset basis so a different hash function can be chosen.
+ * @return
+ */
+std::uint64_t hash_string(std::string_view str, std::uint64_t seed = 0);
+
+/**
+ * @brief Hash of a string read 8 bytes at a time, so a key costs a multiply per word rather than per byte as in
+ * hash_string.  The last word overlaps the one before it instead of being read a byte at a time.  Inline since
+ * perfect_hash calls it on every lookup.
+ * @param str
+ * @param seed
+ * @return
+ */
+inline std::uint64_t hash_words(std::string_view str, std::uint64_t seed) {
+    std::uint64_t hash = (seed + 1) * 0x9E3779B97F4A7C15ull ^ str.size();
+    char const* const data = str.data();
+    std::size_t const size = str.size();
+    std::uint64_t word = 0;
+    if (size >= 8) {
+        for (std::size_t i = 0; i + 8 < size; i += 8) {
+            std::memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 32;
+        }
+        std::memcpy(&word, data + size - 8, 8);
+    } else if (size >= 4) {
+        std::uint32_t first;
+        std::uint32_t last;
+        std::memcpy(&first, data, 4);
+        std::memcpy(&last, data + size - 4, 4);
+        word = std::uint64_t(first) << 32 | last;
+    } else if (size) {
+        // Covers every byte of a string this short
+        word = std::uint64_t(static_cast<unsigned char>(data[0])) << 16 |
+               std::uint64_t(static_cast<unsigned char>(data[size / 2])) << 8 |
+               static_cast<unsigned char>(data[size - 1]);
+    }
+    hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 29)) * 0x94D049BB133111EBull;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Perfect hash over a fixed set of keys built via hash and displace.  Every key maps to a distinct slot so a
+ * lookup is a single string hash, a table read and an integer mix.  Keys not in the set map to an arbitrary slot, so
+ * the caller must compare the key stored at the slot.  Comparing the key_hash stored with it first rejects most of
+ * those without touching the key.
+ */
+class perfect_hash {
+   public:
+    perfect_hash();
+
+    /**
+     * @brief Builds the hash for keys.  Keys must be unique.
+     * @param keys
+     */
+    explicit perfect_hash(std::vector<std::string_view> const& keys);
+
+    /**
+     * @brief Number of slots, which is at least the number of keys.
+     * @return
+     */
+    std::size_t slot_count() const { return this->slot_mask + 1; }
+
+    /**
+     * @brief The slot key maps to.
+     * @param key
+     * @return A slot less than slot_count().
+     */
+    std::size_t slot(std::string_view key) const { return this->slot_of(this->key_hash(key)); }
+
+    /**
+     * @brief Hash of key that slot is computed from.
+     * @param key
+     * @return
+     */
+    std::uint64_t key_hash(std::string_view key) const { return hash_words(key, this->salt); }
+
+    /**
+     * @brief The slot of the key with hash, see key_hash.
+     * @param hash
+     * @return A slot less than slot_count().
+     */
+    std::size_t slot_of(std::uint64_t hash) const {
+        std::uint64_t const displacement = this->displacements[hash & this->bucket_mask];
+        return mix(hash, displacement) & this->slot_mask;
+    }
+
+   private:
+    static std::uint64_t mix(std::uint64_t hash, std::uint64_t displacement) {
+        std::uint64_t x = hash + displacement * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    bool build(std::vector<std::uint64_t> const& hashes);
+
+    std::uint64_t salt;
+    std::uint64_t bucket_mask;
+    std::uint64_t slot_mask;
+    std::vector<std::uint32_t> displacements;
+};
+
+}  // namespace details
+// \endcond
+}  // namespace yadi
+
+#endif  // YADI_PERFECT_HASH_HPP
@@ -8,6 +8,15 @@
 #include "factory.hpp"
 #include "help.hpp"
 #include "initializers.hpp"
+#include "layered_config.hpp"
+#include "type_id.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
 
 /**
  * @namespace yadi
@@ -16,12 +25,15 @@
 namespace yadi {
 // TODO change argument names
 /**
- * If both types are maps then they are merged with left taking priority.  If right is not defined or is null then left.
- * If left is not defined or is null then right.  Otherwise, error.
+ * If both types are maps then they are merged with right taking priority, each entry copied once from the map
+ * defining it.  If right is not defined or is null then left.  If left is not defined or is null then right.  Neither
+ * is copied in those cases.  Otherwise, error.  See layered_config for lookups without merging.
  * @param left
+ * @param right
+ * @param mode Whether maps under the same key are merged as well
  * @return
  */
-YAML::Node merge_yaml(YAML::Node const& left, YAML::Node const& /* right */);
+YAML::Node merge_yaml(YAML::Node const& left, YAML::Node const& right, merge_mode mode = merge_mode::shallow);
 
 /**
  * @brief Equibalent to factory<BT>::register_type(type, yadis)
@@ -32,6 +44,17 @@ YAML::Node merge_yaml(YAML::Node const& left, YAML::Node const& /* right */);
 template <typename BT>
 void register_type(std::string type, yadi_info_t<BT> yadis);
 
+/**
+ * @brief Equivalent to factory<BT>::register_lazy(type, thunk).  For example
+ * register_type_lazy<shape>("rect", []() { return make_map_initializer_with_help<shape>(&make_rect, fields); }).
+ * @tparam BT
+ * @tparam F Callable returning yadi_info_t<BT>
+ * @param type
+ * @param thunk Called on first use of type
+ */
+template <typename BT, typename F>
+void register_type_lazy(std::string type, F thunk);
+
 // TODO Update comment
 /**
  * @brief
@@ -63,14 +86,18 @@ void register_type_no_arg(std::string type);
 /**
  * @brief Registers alias to type and config pair.  When create is called for alias the passed in
  * and registered configs are merged and the initializer registered to type is called with the
- * result.
+ * result.  Chains of aliases are resolved once, into the initializer at the end of the chain and the
+ * configs along the way merged in advance, and resolved again whenever the factory registers a type.
  * @tparam BT
  * @param alias
  * @param type
  * @param config
+ * @param mode How config is merged with the passed in config, see merge_yaml
+ * @throws std::runtime_error if the alias would form a cycle
  */
 template <typename BT>
-void register_alias(std::string alias, std::string type, YAML::Node config={});
+void register_alias(std::string alias, std::string type, YAML::Node config={},
+                    merge_mode mode = merge_mode::shallow);
 
 /**
  * @brief Loads aliases from a YAML file.  The file should be a map of the format...
@@ -81,12 +108,95 @@ void register_alias(std::string alias, std::string type, YAML::Node config={});
  * For each entry register_alias() is called.
  * @tparam BT
  * @param aliases
+ * @param mode Passed to register_alias()
  */
 template <typename BT>
-void register_aliases(YAML::Node aliases);
+void register_aliases(YAML::Node aliases, merge_mode mode = merge_mode::shallow);
 
 template <typename BT>
-static void register_factory(std::string name = demangle_type<BT>());
+static void register_factory(std::string name = std::string(demangle_type<BT>()));
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief The type an alias names and the config merged with the passed config before creating it.
+ */
+struct alias_hop {
+    alias_hop(std::string target, YAML::Node config, merge_mode mode)
+        : target(std::move(target)), config(std::move(config)), mode(mode) {}
+
+    std::string const target;
+    YAML::Node const config;
+    merge_mode const mode;
+};
+
+/**
+ * @brief Initializer registered by register_alias.  Resolves its chain of aliases to the terminal type and a base
+ * config with every config along the chain merged, so a create is a single merge and call.  Initializers take a
+ * YAML::Node, so the merge still copies the base config's entries the passed config doesn't override.  The resolution
+ * is redone when the factory's generation changes, and a superseded resolution is freed once no thread is using it.  If
+ * the configs along the chain can't be merged without the passed config, the alias falls back to merging and creating
+ * one hop at a time, which reports the error as before.
+ * @tparam BT
+ */
+template <typename BT>
+class alias_initializer {
+   public:
+    alias_initializer(std::string alias, std::string type, YAML::Node config, merge_mode mode)
+        : def(new definition(std::move(alias), std::move(type), std::move(config), mode)) {}
+
+    ptr_type_t<BT> operator()(YAML::Node const& passedConfig) const;
+
+    /**
+     * @brief The hop kept in the alias' yadi_info.
+     */
+    std::shared_ptr<alias_hop const> hop() const { return this->def; }
+
+    /**
+     * @brief Walks the chain of aliases starting at type, the target of alias.  Hops are found through the alias of
+     * each yadi_info, not the initializer, which a registration_mod may have wrapped.
+     * @param alias
+     * @param type
+     * @param visit Called with each alias passed through
+     * @return The type at the end of the chain
+     * @throws std::runtime_error if the chain leads back to alias
+     */
+    template <typename F>
+    static std::string_view follow(std::string_view alias, std::string_view type, F&& visit);
+
+   private:
+    struct resolution {
+        std::uint64_t generation;
+        bool flattened;                      ///< Otherwise hop by hop
+        type_id terminal_id;                 ///< Invalid if the terminal type isn't registered
+        std::string terminal_type;
+        YAML::Node base_config;
+        std::string cycle_error;             ///< Set if the chain leads back to the alias
+    };
+
+    struct definition : public alias_hop {
+        definition(std::string alias, std::string target, YAML::Node config, merge_mode mode)
+            : alias_hop(std::move(target), std::move(config), mode),
+              alias(std::move(alias)),
+              target_id(type_id::intern(this->target)) {}
+
+        std::string const alias;
+        type_id const target_id;
+
+        std::mutex resolve_mutex;
+        /// Loaded and stored with std::atomic_load and std::atomic_store.  Readers hold their own reference, so a
+        /// superseded resolution is freed once the last create using it returns.
+        std::shared_ptr<resolution const> resolved;
+    };
+
+    std::shared_ptr<resolution const> resolve() const;
+
+    std::shared_ptr<definition> def;  ///< Shared since initializers copy their target
+};
+
+}  // namespace details
+// \endcond
 
 // ############################ IMPL ##########################
 
@@ -95,6 +205,11 @@ void register_type(std::string type, yadi_info_t<BT> yadis) {
     factory<BT>::register_type(type, yadis);
 }
 
+template <typename BT, typename F>
+void register_type_lazy(std::string type, F thunk) {
+    factory<BT>::register_lazy(std::move(type), std::move(thunk));
+}
+
 template <typename BT>
 void register_type(std::string type, initializer_type_t<BT> initializer) {
     register_type<BT>(type, {initializer, "No help provided"});
@@ -107,25 +222,28 @@ void register_type(std::string type) {
 
 template <typename BT, typename IT>
 void register_type_no_arg(std::string type) {
-    register_type<BT>(type, {&init_no_arg<BT, IT>, "No config"});
+    register_type<BT>(type, {&init_no_arg<BT, IT>, "No config",
+                             [](config_node const&) { return init_no_arg<BT, IT>(YAML::Node()); }});
 }
 
 template <typename BT>
-void register_alias(std::string alias, std::string type, YAML::Node config) {
-    register_type<BT>(alias, [type, config](YAML::Node const& passedConfig) {
-        YAML::Node mergedConfig = merge_yaml(config, passedConfig);
-        return factory<BT>::create(type, mergedConfig);
-    });
+void register_alias(std::string alias, std::string type, YAML::Node config, merge_mode mode) {
+    details::alias_initializer<BT>::follow(alias, type, [](auto const&) {});
+    details::alias_initializer<BT> initializer(alias, std::move(type), std::move(config), mode);
+    yadi_info_t<BT> yadis{{}, "No help provided"};
+    yadis.alias = initializer.hop();
+    yadis.initializer = initializer_type_t<BT>(std::move(initializer));
+    register_type<BT>(std::move(alias), std::move(yadis));
 }
 
 template <typename BT>
-void register_aliases(YAML::Node aliases) {
+void register_aliases(YAML::Node aliases, merge_mode mode) {
     // TODO error handling
     std::map<std::string, YAML::Node> aliasesMap = aliases.as<std::map<std::string, YAML::Node>>();
     for (auto const& entry : aliasesMap) {
         std::string type = entry.second["type"].as<std::string>();
         YAML::Node config = entry.second["config"];
-        register_alias<BT>(entry.first, type, config);
+        register_alias<BT>(entry.first, type, config, mode);
     }
 }
 
@@ -134,6 +252,96 @@ static void register_factory(std::string name) {
     yadi_help::register_factory<BT>(name, factory<BT>::types());
 }
 
+namespace details {
+
+template <typename BT>
+ptr_type_t<BT> alias_initializer<BT>::operator()(YAML::Node const& passedConfig) const {
+    std::shared_ptr<resolution const> resolved =
+        std::atomic_load_explicit(&this->def->resolved, std::memory_order_acquire);
+    if (!resolved || resolved->generation != factory<BT>::generation()) {
+        resolved = this->resolve();
+    }
+
+    if (!resolved->cycle_error.empty()) {
+        throw std::runtime_error(resolved->cycle_error);
+    }
+    if (!resolved->flattened) {
+        YAML::Node mergedConfig = merge_yaml(this->def->config, passedConfig, this->def->mode);
+        return factory<BT>::create(this->def->target_id, mergedConfig);
+    }
+    if (!resolved->terminal_id.valid()) {
+        create_error(error_code::type_not_found, resolved->terminal_type, demangle_type<BT>()).raise();
+    }
+
+    // Created by id so the terminal is traced, timed and its errors reported as any other create
+    YAML::Node mergedConfig = merge_yaml(resolved->base_config, passedConfig, this->def->mode);
+    return factory<BT>::create(resolved->terminal_id, mergedConfig);
+}
+
+template <typename BT>
+template <typename F>
+std::string_view alias_initializer<BT>::follow(std::string_view alias, std::string_view type, F&& visit) {
+    // alias is visited first since it will name the alias once registered, whatever it names now
+    std::vector<std::string_view> visited{alias};
+    while (true) {
+        if (std::find(visited.begin(), visited.end(), type) != visited.end()) {
+            throw std::runtime_error("Alias \"" + std::string(alias) + "\" to \"" + std::string(type) +
+                                     "\" forms a cycle in \"" + std::string(demangle_type<BT>()) + "\" factory");
+        }
+        yadi_info_t<BT> const* yadis = factory<BT>::find(type);
+        if (!yadis || !yadis->alias) {
+            break;
+        }
+        visited.push_back(type);
+        visit(*yadis->alias);
+        type = yadis->alias->target;
+    }
+    return type;
+}
+
+template <typename BT>
+std::shared_ptr<typename alias_initializer<BT>::resolution const> alias_initializer<BT>::resolve() const {
+    std::lock_guard<std::mutex> lock(this->def->resolve_mutex);
+    std::uint64_t const generation = factory<BT>::generation();
+    std::shared_ptr<resolution const> resolved =
+        std::atomic_load_explicit(&this->def->resolved, std::memory_order_relaxed);
+    if (resolved && resolved->generation == generation) {
+        return resolved;
+    }
+
+    // Nearer configs take priority, as they would merging hop by hop
+    std::shared_ptr<resolution> next(new resolution{generation, true, type_id(), {}, this->def->config, {}});
+    try {
+        std::string_view const terminal =
+            follow(this->def->alias, this->def->target, [this, &next](alias_hop const& hop) {
+                // Shallow and deep merges don't combine in advance
+                if (hop.mode != this->def->mode) {
+                    next->flattened = false;
+                }
+                if (next->flattened) {
+                    try {
+                        next->base_config = merge_yaml(hop.config, next->base_config, this->def->mode);
+                    } catch (std::exception const&) {
+                        next->flattened = false;
+                    }
+                }
+            });
+        next->terminal_type = std::string(terminal);
+        if (factory<BT>::find(terminal)) {
+            next->terminal_id = type_id::find(terminal);
+        }
+    } catch (std::exception const& ex) {
+        // Only possible if aliases forming a cycle were registered concurrently
+        next->cycle_error = ex.what();
+    }
+
+    std::atomic_store_explicit(&this->def->resolved, std::shared_ptr<resolution const>(next),
+                               std::memory_order_release);
+    return next;
+}
+
+}  // namespace details
+
 }  // namespace yadi
 
 #endif  // YADI_REGISTRATION_HPP
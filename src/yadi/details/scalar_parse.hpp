@@ -0,0 +1,83 @@
+#ifndef YADI_SCALAR_PARSE_HPP
+#define YADI_SCALAR_PARSE_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief Whether T is a character type, which yaml-cpp converts as a character rather than a number.
+ * Signed and unsigned char are read as numbers and aren't included.
+ */
+template <typename T>
+struct is_char_scalar
+    : std::integral_constant<bool, std::is_same<T, char>::value || std::is_same<T, wchar_t>::value ||
+#ifdef __cpp_char8_t
+                                       std::is_same<T, char8_t>::value ||
+#endif
+                                       std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value> {};
+
+/**
+ * @brief Whether parse_scalar can read T.
+ */
+template <typename T>
+struct is_parsed_scalar
+    : std::integral_constant<bool, (std::is_arithmetic<T>::value && !is_char_scalar<T>::value) ||
+                                       std::is_same<T, std::string>::value> {};
+
+/**
+ * @brief Parses scalar as T without iostreams, for the forms std::from_chars reads the same as yaml-cpp's as<T>().
+ * Those are decimal numbers without a leading + or 0, true and false, and any std::string.
+ * @return False for anything else, such as hex, octal, .inf, yes, values out of range or any T that isn't
+ * is_parsed_scalar, such as char.  Those are left to yaml-cpp,
+ * which converts them or reports the error.
+ */
+template <typename T>
+bool parse_scalar(std::string_view scalar, T& out) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        out.assign(scalar.data(), scalar.size());
+        return true;
+    } else if constexpr (std::is_same<T, bool>::value) {
+        if (scalar == "true" || scalar == "false") {
+            out = scalar == "true";
+            return true;
+        }
+        return false;
+    } else if constexpr (is_parsed_scalar<T>::value) {
+        if constexpr (std::is_integral<T>::value) {
+            // yaml-cpp reads a leading 0 as octal
+            std::size_t const first = !scalar.empty() && scalar[0] == '-' ? 1 : 0;
+            if (scalar.size() > first + 1 && scalar[first] == '0') {
+                return false;
+            }
+        } else {
+            // from_chars reads inf and nan, which YAML spells .inf and .nan
+            if (scalar.find_first_of("iInN") != std::string_view::npos) {
+                return false;
+            }
+        }
+        std::from_chars_result const parsed = std::from_chars(scalar.data(), scalar.data() + scalar.size(), out);
+        return parsed.ec == std::errc() && parsed.ptr == scalar.data() + scalar.size();
+    } else {
+        return false;
+    }
+}
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
+
+#endif  // YADI_SCALAR_PARSE_HPP
@@ -0,0 +1,247 @@
+#ifndef YADI_STATIC_REGISTRY_HPP
+#define YADI_STATIC_REGISTRY_HPP
+
+#include "create_utils.hpp"
+#include "factory.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief A type of a static_registry.  NAME must be a constexpr character array, such as
+ * constexpr char RECT[] = "rect", and INIT a function taking the YAML config, such as &init_yaml<shape, rect>.
+ * @tparam NAME The type name
+ * @tparam INIT The initializer
+ */
+template <char const* NAME, auto INIT>
+struct static_type {
+    static constexpr std::string_view name = NAME;
+    static constexpr auto initializer = INIT;
+};
+
+// \cond DEV_DOCS
+namespace details {
+
+struct static_name_entry {
+    std::string_view name;
+    std::size_t index;  ///< Position of the type in the registry's type list
+};
+
+template <std::size_t N>
+constexpr std::array<static_name_entry, N> sort_static_names(std::array<static_name_entry, N> entries) {
+    // Insertion sort, std::sort isn't constexpr
+    for (std::size_t i = 1; i < N; ++i) {
+        for (std::size_t j = i; j > 0 && entries[j].name < entries[j - 1].name; --j) {
+            static_name_entry const swapped = entries[j];
+            entries[j] = entries[j - 1];
+            entries[j - 1] = swapped;
+        }
+    }
+    return entries;
+}
+
+template <typename... TYPES, std::size_t... I>
+constexpr std::array<static_name_entry, sizeof...(TYPES)> sorted_static_names(std::index_sequence<I...>) {
+    return sort_static_names(std::array<static_name_entry, sizeof...(TYPES)>{static_name_entry{TYPES::name, I}...});
+}
+
+constexpr std::uint64_t static_name_hash(std::string_view name) {
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+constexpr std::size_t static_slot_count(std::size_t count) {
+    std::size_t slots = 1;
+    while (slots < count * 2) {
+        slots *= 2;
+    }
+    return slots;
+}
+
+/**
+ * @brief Open addressed table of the position in the type list of each name, plus one so zero is an empty slot.
+ */
+template <std::size_t SLOTS, std::size_t N>
+constexpr std::array<std::size_t, SLOTS> static_name_slots(std::array<std::string_view, N> const& names) {
+    std::array<std::size_t, SLOTS> slots{};
+    for (std::size_t i = 0; i < N; ++i) {
+        std::size_t slot = static_name_hash(names[i]) & (SLOTS - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (SLOTS - 1);
+        }
+        slots[slot] = i + 1;
+    }
+    return slots;
+}
+
+template <std::size_t N>
+constexpr bool unique_static_names(std::array<static_name_entry, N> const& sorted) {
+    for (std::size_t i = 1; i < N; ++i) {
+        if (sorted[i].name == sorted[i - 1].name) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace details
+// \endcond
+
+/**
+ * @brief Factory for BT whose types are fixed at compile time.  The name lookup table is built at compile time and
+ * create dispatches through a constant table of initializers, so there's no heap state and nothing runs before main.
+ * Names not in TYPES are passed to factory<BT>, so runtime registration, aliases included, keeps working alongside.  To
+ * have from_yaml use the registry, specialize adapter<BT> as static_adapter<registry>.  Static types are traced and,
+ * with YADI_INSTRUMENT, counted like factory<BT> types of the same name.  There's no registration to apply
+ * registration_mod<BT> to, so BT must not have one.
+ * @tparam BT Base type
+ * @tparam TYPES static_type of each type
+ */
+template <typename BT, typename... TYPES>
+struct static_registry {
+    using base_type = BT;
+    using ptr_type = ptr_type_t<BT>;
+    using initializer_type = ptr_type (*)(YAML::Node const&);
+
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    /// The type names in sorted order
+    static constexpr std::array<details::static_name_entry, sizeof...(TYPES)> sorted_names =
+        details::sorted_static_names<TYPES...>(std::index_sequence_for<TYPES...>());
+
+    static_assert(details::unique_static_names(sorted_names), "static_registry type names must be unique");
+    static_assert(details::is_default_registration_mod<BT>::value,
+                  "static_registry types aren't registered, so registration_mod<BT> can't be applied to them");
+
+    /**
+     * @brief Position of type in TYPES, found in a hash table built at compile time.
+     * @param type
+     * @return The index or npos
+     */
+    static constexpr std::size_t index_of(std::string_view type) {
+        std::size_t slot = details::static_name_hash(type) & (SLOT_COUNT - 1);
+        while (std::size_t const entry = slots[slot]) {
+            if (names[entry - 1] == type) {
+                return entry - 1;
+            }
+            slot = (slot + 1) & (SLOT_COUNT - 1);
+        }
+        return npos;
+    }
+
+    static constexpr bool contains(std::string_view type) { return index_of(type) != npos; }
+
+    /**
+     * @brief Calls the initializer of type, or factory<BT>::create if type isn't in TYPES.
+     * @param type
+     * @param config
+     * @return
+     * @throws std::runtime_error if type isn't found or its initializer throws, same as factory<BT>::create
+     */
+    static ptr_type create(std::string_view type, YAML::Node const& config = {}) {
+        std::size_t const index = index_of(type);
+        if (index == npos) {
+            return factory<BT>::create(type, config);
+        }
+        return invoke(index, type, config);
+    }
+
+    /**
+     * @brief See create(std::string_view, YAML::Node const&).  Static types are passed config converted to YAML.
+     */
+    static ptr_type create(std::string_view type, config_node const& config) {
+        std::size_t const index = index_of(type);
+        if (index == npos) {
+            return factory<BT>::create(type, config);
+        }
+        return invoke(index, type, config.to_yaml());
+    }
+
+    /**
+     * @brief Calls the initializer of the type at position I of TYPES directly, which the compiler can inline.
+     */
+    template <std::size_t I>
+    static ptr_type create_at(YAML::Node const& config = {}) {
+        return measured(I, [&config]() { return std::tuple_element_t<I, std::tuple<TYPES...>>::initializer(config); });
+    }
+
+    /**
+     * @brief Registers each type with factory<BT> too, for help, the inspector and lookups by type_id.
+     * @param help Help registered with each type
+     */
+    static void register_types(std::string const& help = "") {
+        (factory<BT>::register_type(std::string(TYPES::name), {TYPES::initializer, help}), ...);
+    }
+
+   private:
+    static constexpr std::array<initializer_type, sizeof...(TYPES)> initializers{TYPES::initializer...};
+    static constexpr std::array<std::string_view, sizeof...(TYPES)> names{TYPES::name...};
+    static constexpr std::size_t SLOT_COUNT = details::static_slot_count(sizeof...(TYPES));
+    static constexpr std::array<std::size_t, SLOT_COUNT> slots = details::static_name_slots<SLOT_COUNT>(names);
+
+    static ptr_type invoke(std::size_t index, std::string_view type, YAML::Node const& config) {
+        try {
+            return measured(index, [index, &config]() { return initializers[index](config); });
+        } catch (std::exception const& ex) {
+            throw std::runtime_error("Error creating \"" + std::string(type) + "\": " + ex.what());
+        }
+    }
+
+    /**
+     * @brief Calls call within a trace span and the create metrics of the type at index, as factory<BT>::invoke does.
+     */
+    template <typename F>
+    static ptr_type measured(std::size_t index, F&& call) {
+        details::trace_span span;
+        if (trace_sink* sink = details::active_trace_sink()) {
+            span.begin(sink, trace_kind::create, demangle_type<BT>(), names[index]);
+        }
+#ifdef YADI_INSTRUMENT
+        // The same slots factory<BT> counts types of these names in
+        static std::array<std::size_t, sizeof...(TYPES)> const metrics_slots{
+            details::create_metrics_slot(demangle_type<BT>(), TYPES::name)...};
+        details::create_timer timer(metrics_slots[index]);
+#endif
+        return call();
+    }
+};
+
+/**
+ * @brief Adapter creating through a static_registry, for example
+ * template <> struct adapter<shape> : static_adapter<shape_registry> {};
+ * @tparam SR The static_registry
+ */
+template <typename SR>
+struct static_adapter {
+    using base_type = typename SR::base_type;
+    using output_type = typename SR::ptr_type;
+    static constexpr bool direct_from_yaml = factory_traits<base_type>::direct_from_yaml;
+
+    static output_type create(std::string_view type, YAML::Node const& config = {}) { return SR::create(type, config); }
+
+    static output_type create(std::string_view type, config_node const& config) { return SR::create(type, config); }
+
+    static std::string_view get_name() { return yadi_help::get_name<base_type>(); }
+};
+
+}  // namespace yadi
+
+#endif  // YADI_STATIC_REGISTRY_HPP
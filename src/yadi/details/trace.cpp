@@ -0,0 +1,237 @@
+#include "trace.hpp"
+#include "json.hpp"
+#include "perfect_hash.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+
+namespace yadi {
+
+namespace {
+
+char const* kind_name(trace_kind kind) {
+    switch (kind) {
+        case trace_kind::create:
+            return "create";
+        case trace_kind::from_yaml:
+            return "from_yaml";
+        case trace_kind::adapter:
+            return "adapter";
+    }
+    return "";
+}
+
+trace_record to_record(trace_event const& event) {
+    return trace_record{event.phase, event.kind,   std::string(event.factory), std::string(event.type),
+                        event.line,  event.column, event.timestamp,            event.thread};
+}
+
+}  // anonymous namespace
+
+void set_trace_sink(trace_sink* sink) { details::TRACE_SINK.store(sink, std::memory_order_release); }
+
+trace_sink* get_trace_sink() { return details::active_trace_sink(); }
+
+void write_chrome_trace(std::ostream& out, std::vector<trace_record> const& records) {
+    out << "{\"traceEvents\": [";
+    bool first = true;
+    for (trace_record const& record : records) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+
+        // Timestamps are in microseconds
+        char timestamp[32];
+        std::snprintf(timestamp, sizeof(timestamp), "%.3f", record.timestamp / 1000.0);
+        out << "  {\"ph\": \"" << (record.phase == trace_phase::begin ? 'B' : 'E') << "\", \"ts\": " << timestamp
+            << ", \"pid\": 1, \"tid\": " << record.thread;
+        if (record.phase == trace_phase::begin) {
+            out << ", \"name\": " << details::json_string(record.type) << ", \"cat\": \"" << kind_name(record.kind)
+                << "\", \"args\": {\"factory\": " << details::json_string(record.factory);
+            if (record.line >= 0) {
+                out << ", \"line\": " << record.line << ", \"column\": " << record.column;
+            }
+            out << '}';
+        }
+        out << '}';
+    }
+    out << "\n]}\n";
+}
+
+void chrome_trace_sink::record(trace_event const& event) {
+    trace_record record = to_record(event);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->events.push_back(std::move(record));
+}
+
+std::vector<trace_record> chrome_trace_sink::records() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->events;
+}
+
+void chrome_trace_sink::write(std::ostream& out) const { write_chrome_trace(out, this->records()); }
+
+/**
+ * @brief Names recorded by a trace_ring_sink, each copied once and numbered by its entry.  Open addressed with a
+ * bounded probe, so a name seen before is found without locking, and once its probe is full a name is recorded as
+ * "..." rather than the table growing.
+ */
+struct trace_ring_sink::name_table {
+    static constexpr std::uint32_t CAPACITY = 4096;
+    static constexpr std::uint32_t MAX_PROBES = 64;
+    static constexpr std::uint32_t EMPTY = CAPACITY;           ///< ID of the empty name
+    static constexpr std::uint32_t OVERFLOWED = CAPACITY + 1;  ///< ID of names that didn't fit
+
+    ~name_table() {
+        for (std::atomic<std::string const*>& entry : this->entries) {
+            delete entry.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::uint32_t id(std::string_view name) {
+        if (name.empty()) {
+            return EMPTY;
+        }
+        std::uint64_t const hash = details::hash_words(name, 0);
+        for (std::uint32_t probe = 0; probe < MAX_PROBES; ++probe) {
+            std::uint32_t const index = static_cast<std::uint32_t>(hash + probe) & (CAPACITY - 1);
+            std::string const* entry = this->entries[index].load(std::memory_order_acquire);
+            if (!entry) {
+                std::unique_ptr<std::string const> added(new std::string(name));
+                if (this->entries[index].compare_exchange_strong(entry, added.get(), std::memory_order_acq_rel,
+                                                                 std::memory_order_acquire)) {
+                    added.release();
+                    return index;
+                }
+                // Another thread filled the entry first, entry is what it added
+            }
+            if (*entry == name) {
+                return index;
+            }
+        }
+        return OVERFLOWED;
+    }
+
+    std::string name(std::uint32_t id) const {
+        if (id < CAPACITY) {
+            std::string const* entry = this->entries[id].load(std::memory_order_acquire);
+            return entry ? *entry : std::string();
+        }
+        return id == OVERFLOWED ? "..." : "";
+    }
+
+    std::atomic<std::string const*> entries[CAPACITY] = {};
+};
+
+/**
+ * @brief One event, each field a relaxed atomic so records can read while record writes.  sequence is the position of
+ * the event plus one once it's written and zero while it's being written.
+ */
+struct trace_ring_sink::slot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<std::uint64_t> timestamp{0};
+    std::atomic<std::uint64_t> names{0};     ///< Factory and type name IDs, see name_table
+    std::atomic<std::uint64_t> position{0};  ///< Line and column
+    std::atomic<std::uint64_t> info{0};      ///< Thread, phase and kind
+};
+
+trace_ring_sink::trace_ring_sink(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+    this->mask = size - 1;
+    this->slots.reset(new slot[size]);
+    this->names.reset(new name_table());
+}
+
+trace_ring_sink::~trace_ring_sink() = default;
+
+void trace_ring_sink::record(trace_event const& event) {
+    std::uint64_t const position = this->next.fetch_add(1, std::memory_order_relaxed);
+    slot& entry = this->slots[position & this->mask];
+    entry.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.timestamp.store(event.timestamp, std::memory_order_relaxed);
+    entry.names.store(std::uint64_t(this->names->id(event.factory)) << 32 | this->names->id(event.type),
+                      std::memory_order_relaxed);
+    entry.position.store(std::uint64_t(std::uint32_t(event.line)) << 32 | std::uint32_t(event.column),
+                         std::memory_order_relaxed);
+    entry.info.store(std::uint64_t(event.thread) << 16 | std::uint64_t(event.phase) << 8 | std::uint64_t(event.kind),
+                     std::memory_order_relaxed);
+    entry.sequence.store(position + 1, std::memory_order_release);
+}
+
+std::vector<trace_record> trace_ring_sink::records() const {
+    std::uint64_t const end = this->next.load(std::memory_order_acquire);
+    std::uint64_t const begin = end > this->mask ? end - this->mask - 1 : 0;
+
+    std::vector<trace_record> records;
+    records.reserve(end - begin);
+    for (std::uint64_t position = begin; position < end; ++position) {
+        slot const& entry = this->slots[position & this->mask];
+        if (entry.sequence.load(std::memory_order_acquire) != position + 1) {
+            continue;
+        }
+        std::uint64_t const timestamp = entry.timestamp.load(std::memory_order_relaxed);
+        std::uint64_t const ids = entry.names.load(std::memory_order_relaxed);
+        std::uint64_t const place = entry.position.load(std::memory_order_relaxed);
+        std::uint64_t const info = entry.info.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Overwritten while being read
+        if (entry.sequence.load(std::memory_order_relaxed) != position + 1) {
+            continue;
+        }
+
+        trace_record record;
+        record.phase = static_cast<trace_phase>(info >> 8 & 0xff);
+        record.kind = static_cast<trace_kind>(info & 0xff);
+        record.factory = this->names->name(std::uint32_t(ids >> 32));
+        record.type = this->names->name(std::uint32_t(ids));
+        record.line = static_cast<int>(std::uint32_t(place >> 32));
+        record.column = static_cast<int>(std::uint32_t(place));
+        record.timestamp = timestamp;
+        record.thread = static_cast<std::uint32_t>(info >> 16);
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+void trace_ring_sink::write(std::ostream& out) const { write_chrome_trace(out, this->records()); }
+
+// \cond DEV_DOCS
+namespace details {
+
+std::atomic<trace_sink*> TRACE_SINK{nullptr};
+
+std::uint64_t trace_clock() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::uint32_t trace_thread() {
+    static std::atomic<std::uint32_t> threads{0};
+    thread_local std::uint32_t const thread = ++threads;
+    return thread;
+}
+
+void trace_span::begin(trace_sink* sink, trace_kind kind, std::string_view factory, std::string_view type, int line,
+                       int column) {
+    this->sink = sink;
+    this->kind = kind;
+    this->factory = factory;
+    this->type = type;
+    this->line = line;
+    this->column = column;
+    sink->record(trace_event{trace_phase::begin, kind, factory, type, line, column, trace_clock(), trace_thread()});
+}
+
+void trace_span::finish() {
+    this->sink->record(trace_event{trace_phase::end, this->kind, this->factory, this->type, this->line, this->column,
+                                   trace_clock(), trace_thread()});
+}
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
@@ -0,0 +1,178 @@
+#ifndef YADI_TRACE_HPP
+#define YADI_TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+enum class trace_phase : std::uint8_t { begin, end };
+
+enum class trace_kind : std::uint8_t {
+    create,     ///< factory<BT>::create or try_create
+    from_yaml,  ///< from_yaml or try_from_yaml
+    adapter,    ///< An adapter other than the default, such as a container adapter
+};
+
+/**
+ * @brief One end of a span.  Spans nest on a thread, a from_yaml span holds the create span of the element and that
+ * holds the spans of everything its initializer creates.
+ */
+struct trace_event {
+    trace_phase phase;
+    trace_kind kind;
+    std::string_view factory;  ///< Name of the base type, only valid during the call
+    std::string_view type;     ///< Type created, only valid during the call
+    int line;                  ///< Zero based position of the factory config in its YAML source, -1 if unknown
+    int column;
+    std::uint64_t timestamp;   ///< steady_clock nanoseconds
+    std::uint32_t thread;      ///< Small number identifying the thread
+};
+
+/**
+ * @brief Receives span events from every thread.  See set_trace_sink.
+ */
+class trace_sink {
+   public:
+    virtual ~trace_sink() = default;
+
+    virtual void record(trace_event const& event) = 0;
+};
+
+/**
+ * @brief Sends the spans of every create, from_yaml and adapter call to sink, or stops tracing if sink is nullptr.
+ * Without a sink tracing costs one branch per call.  The sink must outlive every call that started while it was set.
+ * @param sink
+ */
+void set_trace_sink(trace_sink* sink);
+
+trace_sink* get_trace_sink();
+
+/**
+ * @brief An event with its names copied.
+ */
+struct trace_record {
+    trace_phase phase;
+    trace_kind kind;
+    std::string factory;
+    std::string type;
+    int line;
+    int column;
+    std::uint64_t timestamp;
+    std::uint32_t thread;
+};
+
+/**
+ * @brief Writes records in the Chrome trace event format, which chrome://tracing, Perfetto and speedscope load.
+ * @param out
+ * @param records Ordered by timestamp on each thread
+ */
+void write_chrome_trace(std::ostream& out, std::vector<trace_record> const& records);
+
+/**
+ * @brief Keeps every event, for writing as a Chrome trace once the build being traced is done.
+ */
+class chrome_trace_sink : public trace_sink {
+   public:
+    void record(trace_event const& event) override;
+
+    std::vector<trace_record> records() const;
+
+    void write(std::ostream& out) const;
+
+   private:
+    mutable std::mutex mutex;
+    std::vector<trace_record> events;
+};
+
+/**
+ * @brief Keeps the latest events in a fixed size ring of 40 byte records, for tracing a long running process.  Names
+ * are copied into a table of the sink's own, so recording takes no lock and a name seen before isn't copied again.
+ * The table holds up to 4096 names, beyond that names may be recorded as "...".
+ */
+class trace_ring_sink : public trace_sink {
+   public:
+    /**
+     * @param capacity Events kept, rounded up to a power of two
+     */
+    explicit trace_ring_sink(std::size_t capacity = 65536);
+    ~trace_ring_sink() override;
+
+    void record(trace_event const& event) override;
+
+    /**
+     * @brief The events kept, oldest first.  Events being written while this runs are left out.
+     */
+    std::vector<trace_record> records() const;
+
+    void write(std::ostream& out) const;
+
+   private:
+    struct slot;
+    struct name_table;
+
+    std::size_t mask;
+    std::unique_ptr<slot[]> slots;
+    std::unique_ptr<name_table> names;
+    std::atomic<std::uint64_t> next{0};
+};
+
+// \cond DEV_DOCS
+namespace details {
+
+extern std::atomic<trace_sink*> TRACE_SINK;
+
+inline trace_sink* active_trace_sink() { return TRACE_SINK.load(std::memory_order_acquire); }
+
+std::uint64_t trace_clock();
+
+std::uint32_t trace_thread();
+
+/**
+ * @brief Records a begin event when begun and the matching end event when destroyed.  Does nothing unless begun, so
+ * untraced calls only test for a sink.
+ */
+class trace_span {
+   public:
+    trace_span() = default;
+
+    ~trace_span() {
+        if (this->sink) {
+            this->finish();
+        }
+    }
+
+    trace_span(trace_span const&) = delete;
+    trace_span& operator=(trace_span const&) = delete;
+
+    void begin(trace_sink* sink, trace_kind kind, std::string_view factory, std::string_view type, int line = -1,
+               int column = -1);
+
+   private:
+    void finish();
+
+    trace_sink* sink = nullptr;
+    trace_kind kind;
+    std::string_view factory;
+    std::string_view type;
+    int line;
+    int column;
+};
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
+
+#endif  // YADI_TRACE_HPP
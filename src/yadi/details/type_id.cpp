@@ -0,0 +1,52 @@
+#include "type_id.hpp"
+#include "concurrent_store.hpp"
+
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace yadi {
+
+namespace {
+
+/**
+ * @brief Process wide interned type names.  Lookup by name is lock free, interning and lookup by ID lock.
+ */
+struct interned_names {
+    std::mutex mutex;
+    details::concurrent_store<std::uint32_t> ids;
+    std::deque<std::string> names;  ///< Indexed by ID, a deque so the strings never move
+};
+
+interned_names& mut_interned_names() {
+    static interned_names NAMES;
+    return NAMES;
+}
+
+}  // anonymous namespace
+
+std::string_view type_id::name() const {
+    interned_names& interned = mut_interned_names();
+    std::lock_guard<std::mutex> lock(interned.mutex);
+    return this->id < interned.names.size() ? std::string_view(interned.names[this->id]) : std::string_view();
+}
+
+type_id type_id::intern(std::string_view name) {
+    interned_names& interned = mut_interned_names();
+    std::lock_guard<std::mutex> lock(interned.mutex);
+    if (std::uint32_t const* id = interned.ids.find(name)) {
+        return type_id(*id);
+    }
+
+    std::uint32_t const id = static_cast<std::uint32_t>(interned.names.size());
+    interned.names.emplace_back(name);
+    interned.ids.assign(name, id);
+    return type_id(id);
+}
+
+type_id type_id::find(std::string_view name) {
+    std::uint32_t const* id = mut_interned_names().ids.find(name);
+    return id ? type_id(*id) : type_id();
+}
+
+}  // namespace yadi
@@ -0,0 +1,70 @@
+#ifndef YADI_TYPE_ID_HPP
+#define YADI_TYPE_ID_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Dense integer identifying a type name.  Every registered type name is interned once and keeps the same ID for
+ * the life of the process, across factories and re-registration, so IDs may be cached.  See factory<BT>::resolve.
+ */
+class type_id {
+   public:
+    /**
+     * @brief An invalid ID, which no factory has registered.
+     */
+    constexpr type_id() = default;
+
+    constexpr explicit type_id(std::uint32_t value) : id(value) {}
+
+    constexpr std::uint32_t value() const { return this->id; }
+
+    constexpr bool valid() const { return this->id != INVALID; }
+
+    /**
+     * @brief The interned type name.
+     * @return Empty if invalid.
+     */
+    std::string_view name() const;
+
+    /**
+     * @brief Interns name, assigning it the next ID if it has none yet.
+     * @param name
+     * @return
+     */
+    static type_id intern(std::string_view name);
+
+    /**
+     * @brief ID of an already interned name.  Does not lock or allocate.
+     * @param name
+     * @return The ID, which is invalid if name isn't interned.
+     */
+    static type_id find(std::string_view name);
+
+    friend constexpr bool operator==(type_id left, type_id right) { return left.id == right.id; }
+    friend constexpr bool operator!=(type_id left, type_id right) { return left.id != right.id; }
+    friend constexpr bool operator<(type_id left, type_id right) { return left.id < right.id; }
+
+   private:
+    static constexpr std::uint32_t INVALID = std::uint32_t(-1);
+
+    std::uint32_t id = INVALID;
+};
+
+}  // namespace yadi
+
+namespace std {
+template <>
+struct hash<::yadi::type_id> {
+    std::size_t operator()(::yadi::type_id id) const { return id.value(); }
+};
+}  // namespace std
+
+#endif  // YADI_TYPE_ID_HPP
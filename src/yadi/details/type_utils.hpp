@@ -61,8 +61,8 @@ struct derive_base_type<std::shared_ptr<T>> {
     using base_type = bare_t<T>;  // if_convertible_then_t<ptr_type_t<T>, std::shared_ptr<T>, bare_t<T>>;
 };
 
-template <typename T>
-struct derive_base_type<std::unique_ptr<T>> {
+template <typename T, typename D>
+struct derive_base_type<std::unique_ptr<T, D>> {
     using base_type = bare_t<T>;  // if_convertible_then_t<ptr_type_t<T>, std::unique_ptr<T>, bare_t<T>>;
 };
 
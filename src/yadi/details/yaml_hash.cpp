@@ -0,0 +1,168 @@
+#include "yaml_hash.hpp"
+#include "perfect_hash.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace yadi {
+
+namespace {
+
+// Maps at or below this size are compared by scanning instead of sorting
+constexpr std::size_t SMALL_MAP_SIZE = 8;
+
+std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// The non-specific tags only say whether a scalar was quoted, which doesn't change how yadi converts it
+std::string const& explicit_tag(YAML::Node const& yaml) {
+    static std::string const NONE;
+    std::string const& tag = yaml.Tag();
+    return (tag == "?" || tag == "!") ? NONE : tag;
+}
+
+std::uint64_t hash_node(YAML::Node const& yaml) {
+    // Checked first since a missing map entry is an invalid node, which throws if asked its type
+    if (!yaml.IsDefined()) {
+        return 0x5BD1E995ull;
+    }
+
+    switch (yaml.Type()) {
+        case YAML::NodeType::Undefined:
+            return 0x5BD1E995ull;
+        case YAML::NodeType::Null:
+            return 0x27D4EB2Full;
+        case YAML::NodeType::Scalar:
+            return mix(details::hash_string(yaml.Scalar(), 1) ^ details::hash_string(explicit_tag(yaml), 2));
+        case YAML::NodeType::Sequence: {
+            std::uint64_t hash = 0x165667B1ull;
+            for (YAML::Node const& element : yaml) {
+                hash = mix(hash + hash_node(element));
+            }
+            return hash;
+        }
+        case YAML::NodeType::Map: {
+            // Summing entry hashes is independent of the entry order
+            std::uint64_t hash = 0x85EBCA77ull;
+            for (auto const& entry : yaml) {
+                hash += mix(hash_node(entry.first) * 0x9E3779B97F4A7C15ull + hash_node(entry.second));
+            }
+            return mix(hash);
+        }
+    }
+    return 0;
+}
+
+bool equal_node(YAML::Node const& left, YAML::Node const& right);
+
+bool equal_small_map(YAML::Node const& left, YAML::Node const& right) {
+    for (auto const& left_entry : left) {
+        bool found = false;
+        for (auto const& right_entry : right) {
+            if (equal_node(left_entry.first, right_entry.first)) {
+                if (!equal_node(left_entry.second, right_entry.second)) {
+                    return false;
+                }
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool equal_large_map(YAML::Node const& left, YAML::Node const& right) {
+    // Only the (hash, index) pairs are sorted, assigning a YAML::Node would write through to the node it refers to
+    std::vector<std::pair<YAML::Node, YAML::Node>> right_entries;
+    std::vector<std::pair<std::uint64_t, std::size_t>> right_hashes;
+    right_entries.reserve(right.size());
+    right_hashes.reserve(right.size());
+    for (auto const& entry : right) {
+        right_hashes.emplace_back(hash_node(entry.first), right_entries.size());
+        right_entries.emplace_back(entry.first, entry.second);
+    }
+    std::sort(right_hashes.begin(), right_hashes.end());
+
+    for (auto const& left_entry : left) {
+        std::uint64_t const hash = hash_node(left_entry.first);
+        auto match = std::lower_bound(right_hashes.begin(), right_hashes.end(), std::make_pair(hash, std::size_t(0)));
+        for (; match != right_hashes.end() && match->first == hash; ++match) {
+            if (equal_node(left_entry.first, right_entries[match->second].first)) {
+                break;
+            }
+        }
+        if (match == right_hashes.end() || match->first != hash ||
+            !equal_node(left_entry.second, right_entries[match->second].second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool equal_node(YAML::Node const& left, YAML::Node const& right) {
+    if (left.Type() != right.Type()) {
+        return false;
+    }
+
+    switch (left.Type()) {
+        case YAML::NodeType::Undefined:
+        case YAML::NodeType::Null:
+            return true;
+        case YAML::NodeType::Scalar:
+            return left.Scalar() == right.Scalar() && explicit_tag(left) == explicit_tag(right);
+        case YAML::NodeType::Sequence: {
+            if (left.size() != right.size()) {
+                return false;
+            }
+            for (auto left_iter = left.begin(), right_iter = right.begin(); left_iter != left.end();
+                 ++left_iter, ++right_iter) {
+                if (!equal_node(*left_iter, *right_iter)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case YAML::NodeType::Map: {
+            if (left.size() != right.size()) {
+                return false;
+            }
+            // Keys are usually in the same order, so only match up entries once they differ
+            auto left_iter = left.begin();
+            for (auto right_iter = right.begin(); left_iter != left.end(); ++left_iter, ++right_iter) {
+                if (!equal_node(left_iter->first, right_iter->first)) {
+                    break;
+                }
+                if (!equal_node(left_iter->second, right_iter->second)) {
+                    return false;
+                }
+            }
+            if (left_iter == left.end()) {
+                return true;
+            }
+            return left.size() <= SMALL_MAP_SIZE ? equal_small_map(left, right) : equal_large_map(left, right);
+        }
+    }
+    return false;
+}
+
+}  // anonymous namespace
+
+std::size_t yaml_hash(YAML::Node const& yaml) { return static_cast<std::size_t>(hash_node(yaml)); }
+
+bool yaml_equal(YAML::Node const& left, YAML::Node const& right) {
+    if (!left.IsDefined() || !right.IsDefined()) {
+        return left.IsDefined() == right.IsDefined();
+    }
+    return left.is(right) || equal_node(left, right);
+}
+
+}  // namespace yadi
@@ -0,0 +1,59 @@
+#ifndef YADI_YAML_HASH_HPP
+#define YADI_YAML_HASH_HPP
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Structural hash of a YAML tree.  Map entries are combined independent of order, so maps with the same
+ * entries in a different order hash the same.  Consistent with yaml_equal.
+ * @param yaml
+ * @return
+ */
+std::size_t yaml_hash(YAML::Node const& yaml);
+
+/**
+ * @brief Structural equality of YAML trees.  Scalars compare by value and explicit tag, sequences element by element
+ * and maps by their set of entries regardless of order.
+ * @param left
+ * @param right
+ * @return
+ */
+bool yaml_equal(YAML::Node const& left, YAML::Node const& right);
+
+// \cond DEV_DOCS
+namespace details {
+
+/**
+ * @brief YAML node with its structural hash computed once, for use as a hash container key.
+ */
+struct hashed_yaml {
+    explicit hashed_yaml(YAML::Node node) : hash(yaml_hash(node)), node(std::move(node)) {}
+    hashed_yaml(std::size_t hash, YAML::Node node) : hash(hash), node(std::move(node)) {}
+
+    std::size_t hash;
+    YAML::Node node;
+};
+
+struct hashed_yaml_hash {
+    std::size_t operator()(hashed_yaml const& yaml) const { return yaml.hash; }
+};
+
+struct hashed_yaml_equal {
+    bool operator()(hashed_yaml const& left, hashed_yaml const& right) const {
+        return left.hash == right.hash && yaml_equal(left.node, right.node);
+    }
+};
+
+}  // namespace details
+// \endcond
+}  // namespace yadi
+
+#endif  // YADI_YAML_HASH_HPP
@@ -0,0 +1,206 @@
+#include "yaml_stream.hpp"
+
+#include <yaml-cpp/eventhandler.h>
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace yadi {
+
+namespace {
+
+/**
+ * @brief Builds the YAML of each factory config from parser events.  The elements of a document's top level sequence
+ * are built and visited one at a time, any other document is a single element.  Built nodes have no marks, errors are
+ * reported at the mark of their element, which visit is passed.
+ */
+class element_builder : public YAML::EventHandler {
+   public:
+    explicit element_builder(details::yaml_element_visitor const& visit) : visit(visit) {}
+
+    std::size_t count() const { return this->element_count; }
+
+    void OnDocumentStart(YAML::Mark const&) override {
+        this->stack.clear();
+        this->anchors.clear();
+        this->root_started = false;
+    }
+
+    void OnDocumentEnd() override { this->anchors.clear(); }
+
+    void OnNull(YAML::Mark const& mark, YAML::anchor_t anchor) override {
+        this->start_value(mark);
+        YAML::Node node(YAML::NodeType::Null);
+        this->set_anchor(anchor, node);
+        this->complete(node);
+    }
+
+    void OnAlias(YAML::Mark const& mark, YAML::anchor_t anchor) override {
+        this->start_value(mark);
+        anchored const& target = this->anchors.at(anchor - 1);
+        if (!target.node.IsDefined()) {
+            throw std::runtime_error("Alias at line " + std::to_string(mark.line + 1) +
+                                     " refers to the top level sequence, which is streamed rather than built");
+        }
+        // A node anchored in an earlier element is copied so this element doesn't share its memory
+        this->complete(target.element == this->element_count ? target.node : YAML::Clone(target.node));
+    }
+
+    void OnScalar(YAML::Mark const& mark, std::string const& tag, YAML::anchor_t anchor,
+                  std::string const& value) override {
+        this->start_value(mark);
+        YAML::Node node(value);
+        node.SetTag(tag);
+        this->set_anchor(anchor, node);
+        this->complete(node);
+    }
+
+    void OnSequenceStart(YAML::Mark const& mark, std::string const& tag, YAML::anchor_t anchor,
+                         YAML::EmitterStyle::value) override {
+        if (!this->root_started) {
+            // The top level sequence itself is never built, its anchor is recorded so aliases to it can be reported
+            this->root_started = true;
+            this->set_anchor(anchor, YAML::Node(YAML::NodeType::Undefined));
+            return;
+        }
+        this->start_container(mark, tag, anchor, YAML::NodeType::Sequence);
+    }
+
+    void OnSequenceEnd() override {
+        // Otherwise the end of the top level sequence
+        if (!this->stack.empty()) {
+            this->end_container();
+        }
+    }
+
+    void OnMapStart(YAML::Mark const& mark, std::string const& tag, YAML::anchor_t anchor,
+                    YAML::EmitterStyle::value) override {
+        this->start_container(mark, tag, anchor, YAML::NodeType::Map);
+    }
+
+    void OnMapEnd() override { this->end_container(); }
+
+   private:
+    struct frame {
+        YAML::Node node;
+        YAML::Node key;
+        bool has_key;
+    };
+
+    struct anchored {
+        YAML::Node node;
+        std::size_t element;  ///< The element the node is part of
+    };
+
+    void start_value(YAML::Mark const& mark) {
+        this->root_started = true;
+        if (this->stack.empty()) {
+            this->element_mark = mark;
+        }
+    }
+
+    void start_container(YAML::Mark const& mark, std::string const& tag, YAML::anchor_t anchor,
+                         YAML::NodeType::value type) {
+        this->start_value(mark);
+        YAML::Node node(type);
+        node.SetTag(tag);
+        this->set_anchor(anchor, node);
+        this->stack.push_back({node, YAML::Node(), false});
+    }
+
+    void end_container() {
+        YAML::Node const node = this->stack.back().node;
+        this->stack.pop_back();
+        this->complete(node);
+    }
+
+    void set_anchor(YAML::anchor_t anchor, YAML::Node const& node) {
+        if (anchor == YAML::NullAnchor) {
+            return;
+        }
+        if (this->anchors.size() < anchor) {
+            this->anchors.resize(anchor);
+        }
+        this->anchors[anchor - 1] = {node, this->element_count};
+    }
+
+    void complete(YAML::Node const& node) {
+        if (this->stack.empty()) {
+            this->visit(node, this->element_count, this->element_mark);
+            this->end_element();
+            return;
+        }
+
+        frame& parent = this->stack.back();
+        if (parent.node.IsSequence()) {
+            parent.node.push_back(node);
+        } else if (!parent.has_key) {
+            // Rebinds the key, assigning would write through to the previous key's node
+            parent.key.reset(node);
+            parent.has_key = true;
+        } else {
+            parent.node.force_insert(parent.key, node);
+            parent.has_key = false;
+        }
+    }
+
+    // Nodes anchored in the element are copied out of it so the element's memory is freed
+    void end_element() {
+        for (anchored& entry : this->anchors) {
+            if (entry.element == this->element_count && entry.node.IsDefined()) {
+                entry.node = YAML::Clone(entry.node);
+            }
+        }
+        ++this->element_count;
+    }
+
+    details::yaml_element_visitor const& visit;
+    std::vector<frame> stack;
+    std::vector<anchored> anchors;  ///< Indexed by anchor - 1
+    YAML::Mark element_mark;
+    std::size_t element_count = 0;
+    bool root_started = false;
+};
+
+bool blank(std::string const& line) {
+    return std::all_of(line.begin(), line.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+}
+
+}  // anonymous namespace
+
+// \cond DEV_DOCS
+namespace details {
+
+std::size_t for_each_yaml_element(std::istream& input, stream_format format, yaml_element_visitor const& visit) {
+    if (format == stream_format::json_lines) {
+        std::size_t count = 0;
+        YAML::Mark mark;
+        std::string line;
+        for (; std::getline(input, line); ++mark.line) {
+            if (!blank(line)) {
+                visit(YAML::Load(line), count++, mark);
+            }
+        }
+        return count;
+    }
+
+    element_builder builder(visit);
+    YAML::Parser parser(input);
+    while (parser.HandleNextDocument(builder)) {
+    }
+    return builder.count();
+}
+
+memory_streambuf::memory_streambuf(std::string_view memory) {
+    // The buffer is only read, the get area just needs non-const pointers
+    char* begin = const_cast<char*>(memory.data());
+    this->setg(begin, begin, begin + memory.size());
+}
+
+}  // namespace details
+// \endcond
+
+}  // namespace yadi
@@ -0,0 +1,113 @@
+#ifndef YADI_YAML_STREAM_HPP
+#define YADI_YAML_STREAM_HPP
+
+#include "create_utils.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace yadi
+ * @brief YADI
+ */
+namespace yadi {
+
+/**
+ * @brief Layout of a stream of factory configs.
+ */
+enum class stream_format {
+    yaml,       ///< YAML documents, each a sequence of factory configs or a single one
+    json_lines  ///< One factory config per line as JSON (or flow YAML), blank lines are skipped
+};
+
+/**
+ * @brief Streaming from_yamls.  Creates each factory config read from input with from_yaml<OT> and passes it to sink
+ * as soon as the config is parsed, before reading the next.  The YAML of a config is freed once it's created, so
+ * memory is bounded by the largest config rather than the whole input.  A YAML anchor may be referred to by later
+ * configs, in which case a copy of the anchored node is kept until the end of the document.
+ * @tparam OT The desired output type
+ * @tparam F Callable accepting OT
+ * @param input
+ * @param sink Called with each element in order
+ * @param format
+ * @return The number of elements created
+ * @throws std::runtime_error naming the element index and line if an element can't be created.  Elements before it
+ * were already passed to sink.  YAML::ParserException if input isn't valid YAML.
+ */
+template <typename OT, typename F>
+std::size_t from_yaml_stream(std::istream& input, F&& sink, stream_format format = stream_format::yaml);
+
+/**
+ * @brief See from_yaml_stream(std::istream&, F&&, stream_format).  Reads from memory, such as a memory mapped file,
+ * without copying it.
+ * @tparam OT The desired output type
+ * @tparam F Callable accepting OT
+ * @param input
+ * @param sink
+ * @param format
+ * @return The number of elements created
+ */
+template <typename OT, typename F>
+std::size_t from_yaml_stream(std::string_view input, F&& sink, stream_format format = stream_format::yaml);
+
+// \cond DEV_DOCS
+namespace details {
+
+using yaml_element_visitor = std::function<void(YAML::Node const& element, std::size_t index, YAML::Mark const& mark)>;
+
+/**
+ * @brief Parses input one factory config at a time, calling visit with each.
+ * @return The number of factory configs
+ */
+std::size_t for_each_yaml_element(std::istream& input, stream_format format, yaml_element_visitor const& visit);
+
+/**
+ * @brief Read only stream buffer over memory.
+ */
+class memory_streambuf : public std::streambuf {
+   public:
+    explicit memory_streambuf(std::string_view memory);
+};
+
+/**
+ * @brief from_yaml<OT>(element), with errors naming the element.
+ */
+template <typename OT>
+OT create_stream_element(YAML::Node const& element, std::size_t index, YAML::Mark const& mark) {
+    try {
+        return from_yaml<OT>(element);
+    } catch (std::exception const& ex) {
+        throw std::runtime_error("Error creating element " + std::to_string(index) + " at line " +
+                                 std::to_string(mark.line + 1) + ": " + ex.what());
+    }
+}
+
+}  // namespace details
+// \endcond
+
+// ############################ IMPL ############################
+
+template <typename OT, typename F>
+std::size_t from_yaml_stream(std::istream& input, F&& sink, stream_format format) {
+    return details::for_each_yaml_element(
+        input, format, [&sink](YAML::Node const& element, std::size_t index, YAML::Mark const& mark) {
+            sink(details::create_stream_element<OT>(element, index, mark));
+        });
+}
+
+template <typename OT, typename F>
+std::size_t from_yaml_stream(std::string_view input, F&& sink, stream_format format) {
+    details::memory_streambuf buffer(input);
+    std::istream stream(&buffer);
+    return from_yaml_stream<OT>(stream, std::forward<F>(sink), format);
+}
+
+}  // namespace yadi
+
+#endif  // YADI_YAML_STREAM_HPP
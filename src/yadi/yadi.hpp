@@ -1,13 +1,27 @@
 #ifndef YADI_FACTORY_HPP__
 #define YADI_FACTORY_HPP__
 
+#include "details/allocation.hpp"
+#include "details/batch.hpp"
+#include "details/config_ir.hpp"
 #include "details/create_specializations.hpp"
 #include "details/create_utils.hpp"
 #include "details/demangle.hpp"
 #include "details/factory.hpp"
+#include "details/flat_containers.hpp"
 #include "details/help.hpp"
 #include "details/initializers.hpp"
+#include "details/json.hpp"
+#include "details/layered_config.hpp"
+#include "details/metrics.hpp"
 #include "details/registration.hpp"
+#include "details/create_result.hpp"
+#include "details/scalar_parse.hpp"
+#include "details/static_registry.hpp"
+#include "details/trace.hpp"
+#include "details/type_id.hpp"
+#include "details/yaml_hash.hpp"
+#include "details/yaml_stream.hpp"
 
 #include <cstdint>
 
@@ -6,6 +6,33 @@
 
 namespace yadi {
 
+namespace {
+
+struct wrapped {
+    virtual ~wrapped() = default;
+};
+
+struct wrapped_impl : public wrapped {
+    explicit wrapped_impl(YAML::Node const&) {}
+};
+
+int WRAPPED_CREATES = 0;
+
+}  // anonymous namespace
+
+// Wraps every initializer, aliases included
+template <>
+struct registration_mod<wrapped> {
+    static yadi_info_t<wrapped> mod(yadi_info_t<wrapped> yadis) {
+        initializer_type_t<wrapped> initializer = std::move(yadis.initializer);
+        yadis.initializer = [initializer](YAML::Node const& config) {
+            ++WRAPPED_CREATES;
+            return initializer(config);
+        };
+        return yadis;
+    }
+};
+
 YADI_TEST(alias_config_test) {
     yadi::register_type<YAML::Node, YAML::Node>("yaml_type");
     register_alias<YAML::Node>("yaml_alias", "yaml_type", YAML::Load("Hello World!"));
@@ -49,4 +76,93 @@ yaml2:
 
     return true;
 }
+
+YADI_TEST(alias_chain_test) {
+    yadi::register_type<YAML::Node, YAML::Node>("chain_base");
+    register_alias<YAML::Node>("chain1", "chain_base", YAML::Load("{a: 1, b: 1, c: 1}"));
+    register_alias<YAML::Node>("chain2", "chain1", YAML::Load("{b: 2, c: 2}"));
+    register_alias<YAML::Node>("chain3", "chain2", YAML::Load("{c: 3}"));
+
+    // Nearer configs take priority
+    YAML::Node config = factory<YAML::Node>::create("chain3");
+    YADI_ASSERT_EQ(1, config["a"].as<int>());
+    YADI_ASSERT_EQ(2, config["b"].as<int>());
+    YADI_ASSERT_EQ(3, config["c"].as<int>());
+
+    config = factory<YAML::Node>::create("chain3", YAML::Load("{a: 9}"));
+    YADI_ASSERT_EQ(9, config["a"].as<int>());
+    YADI_ASSERT_EQ(3, config["c"].as<int>());
+
+    // Configs that only conflict with a passed config still fail on create
+    register_alias<YAML::Node>("chain_scalar", "chain1", YAML::Load("scalar"));
+    try {
+        factory<YAML::Node>::create("chain_scalar");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    return true;
+}
+
+YADI_TEST(alias_reregister_test) {
+    yadi::register_type<YAML::Node>("rechain_base", [](YAML::Node const&) { return YAML::Load("first"); });
+    register_alias<YAML::Node>("rechain1", "rechain_base");
+    register_alias<YAML::Node>("rechain2", "rechain1");
+    YADI_ASSERT_EQ(std::string("first"), factory<YAML::Node>::create("rechain2").as<std::string>());
+
+    yadi::register_type<YAML::Node>("rechain_base", [](YAML::Node const&) { return YAML::Load("second"); });
+    YADI_ASSERT_EQ(std::string("second"), factory<YAML::Node>::create("rechain2").as<std::string>());
+
+    // An alias in the middle of the chain replaced by a type
+    yadi::register_type<YAML::Node>("rechain1", [](YAML::Node const&) { return YAML::Load("third"); });
+    YADI_ASSERT_EQ(std::string("third"), factory<YAML::Node>::create("rechain2").as<std::string>());
+
+    // Aliases may be registered before their type
+    register_alias<YAML::Node>("rechain_early", "rechain_late");
+    try {
+        factory<YAML::Node>::create("rechain_early");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+    yadi::register_type<YAML::Node>("rechain_late", [](YAML::Node const&) { return YAML::Load("late"); });
+    YADI_ASSERT_EQ(std::string("late"), factory<YAML::Node>::create("rechain_early").as<std::string>());
+
+    return true;
+}
+
+YADI_TEST(alias_cycle_test) {
+    register_alias<YAML::Node>("cycle1", "cycle2");
+    try {
+        register_alias<YAML::Node>("cycle2", "cycle1");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+    try {
+        register_alias<YAML::Node>("cycle3", "cycle3");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    return true;
+}
+
+YADI_TEST(alias_cycle_mod_test) {
+    yadi::register_type<wrapped, wrapped_impl>("wrapped");
+    register_alias<wrapped>("wrapped_alias", "wrapped");
+    register_alias<wrapped>("wrapped_chain", "wrapped_alias");
+    WRAPPED_CREATES = 0;
+    YADI_ASSERT_NE(nullptr, factory<wrapped>::create("wrapped_chain").get());
+    // The chain is flattened past the alias in the middle
+    YADI_ASSERT_EQ(2, WRAPPED_CREATES);
+
+    // Found under the mod's wrapping, rather than recursing on create
+    register_alias<wrapped>("wrapped_cycle1", "wrapped_cycle2");
+    try {
+        register_alias<wrapped>("wrapped_cycle2", "wrapped_cycle1");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    return true;
+}
 }  // namespace yadi
@@ -0,0 +1,157 @@
+#include "test.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Allocations are only counted on the thread that asked for them
+thread_local bool COUNT_ALLOCATIONS = false;
+thread_local std::size_t ALLOCATIONS = 0;
+
+// Every form of operator new and delete is replaced so memory is always freed the way it was allocated
+void* allocate(std::size_t size, std::size_t alignment) noexcept {
+    if (COUNT_ALLOCATIONS) {
+        ++ALLOCATIONS;
+    }
+    size = size ? size : 1;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    // aligned_alloc takes a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+    if (void* ptr = allocate(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+}  // anonymous namespace
+
+void* operator new(std::size_t size) { return allocate_or_throw(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return allocate_or_throw(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::nothrow_t const&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t, std::nothrow_t const&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, std::nothrow_t const&) noexcept { std::free(ptr); }
+
+namespace yadi {
+namespace {
+
+struct lookup_service {
+    int value;
+};
+
+struct pooled_strategy {
+    virtual ~pooled_strategy() = default;
+    virtual int value() const = 0;
+};
+
+struct pooled_offset : public pooled_strategy {
+    explicit pooled_offset(int offset) : offset(offset) {}
+    int value() const override { return offset; }
+    int offset;
+};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<lookup_service> {
+    using ptr_type = lookup_service;
+    static constexpr bool direct_from_yaml = false;
+};
+
+template <>
+struct factory_traits<pooled_strategy> {
+    using ptr_type = std::shared_ptr<pooled_strategy>;
+    static constexpr bool direct_from_yaml = false;
+    using allocation = pool_allocation;
+};
+
+namespace {
+
+// Longer than any small string buffer
+char const LONG_TYPE_NAME[] = "a_lookup_service_with_a_name_too_long_for_small_strings";
+
+template <typename F>
+std::size_t count_allocations(F&& func) {
+    ALLOCATIONS = 0;
+    COUNT_ALLOCATIONS = true;
+    func();
+    COUNT_ALLOCATIONS = false;
+    return ALLOCATIONS;
+}
+
+YADI_TEST(allocation_free_lookup_test) {
+    ::yadi::register_type<lookup_service>(LONG_TYPE_NAME, [](YAML::Node const&) { return lookup_service{7}; });
+
+    YAML::Node const scalar_config = YAML::Load(LONG_TYPE_NAME);
+    YAML::Node const map_config = YAML::Load(std::string("{type: ") + LONG_TYPE_NAME + ", config: {a: 1}}");
+    std::string const type = LONG_TYPE_NAME;
+    int total = 0;
+
+    auto lookups = [&]() {
+        total += factory<lookup_service>::create(LONG_TYPE_NAME).value;
+        total += factory<lookup_service>::create(type).value;
+        total += ::yadi::create<lookup_service>(type, map_config).value;
+        total += from_yaml<lookup_service>(scalar_config).value;
+        total += from_yaml<lookup_service>(map_config).value;
+    };
+
+    lookups();
+    YADI_ASSERT_EQ(0u, count_allocations(lookups));
+
+    factory<lookup_service>::freeze();
+    YADI_ASSERT_EQ(0u, count_allocations(lookups));
+    YADI_ASSERT_EQ(105, total);
+
+    // The counter works
+    YADI_ASSERT_NE(0u, count_allocations([]() { ::operator delete(::operator new(64)); }));
+
+    return true;
+}
+
+YADI_TEST(allocation_free_pooled_create_test) {
+    int total = 0;
+    auto create = [&total]() { total += ctr<pooled_strategy, pooled_offset>(2)->value(); };
+    // The first creation on a thread takes a slab
+    create();
+    YADI_ASSERT_EQ(0u, count_allocations(create));
+    YADI_ASSERT_EQ(4, total);
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
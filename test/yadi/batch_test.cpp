@@ -0,0 +1,94 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct batch_service {
+    int id;
+    std::thread::id thread;
+};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<batch_service> {
+    using ptr_type = std::unique_ptr<batch_service>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+YADI_INIT_BEGIN
+register_type<batch_service>("batch_service", [](YAML::Node const& config) {
+    int const id = config["id"].as<int>();
+    if (id < 0) {
+        throw std::runtime_error("Negative id");
+    }
+    // Long enough for the other threads to pick up elements
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return std::unique_ptr<batch_service>(new batch_service{id, std::this_thread::get_id()});
+});
+YADI_INIT_END
+
+YAML::Node batch_configs(std::size_t count, std::set<int> const& failing = {}) {
+    YAML::Node configs;
+    for (std::size_t i = 0; i < count; ++i) {
+        YAML::Node config;
+        config["type"] = "batch_service";
+        config["config"]["id"] = failing.count(i) ? -1 : static_cast<int>(i);
+        configs.push_back(config);
+    }
+    return configs;
+}
+
+YADI_TEST(batch_order_test) {
+    std::vector<std::unique_ptr<batch_service>> services;
+    from_yamls_parallel<std::unique_ptr<batch_service>>(batch_configs(64), std::back_inserter(services), 4);
+    YADI_ASSERT_EQ(64u, services.size());
+
+    std::set<std::thread::id> threads;
+    for (std::size_t i = 0; i < services.size(); ++i) {
+        YADI_ASSERT_EQ(static_cast<int>(i), services[i]->id);
+        threads.insert(services[i]->thread);
+    }
+    YADI_ASSERT_EQ(true, (threads.size() > 1u));
+
+    // A single factory config is a batch of one
+    std::vector<std::unique_ptr<batch_service>> single;
+    from_yamls_parallel<std::unique_ptr<batch_service>>(batch_configs(1)[0], std::back_inserter(single));
+    YADI_ASSERT_EQ(1u, single.size());
+
+    return true;
+}
+
+YADI_TEST(batch_errors_test) {
+    batch_result<std::unique_ptr<batch_service>> result =
+        create_batch<std::unique_ptr<batch_service>>(batch_configs(32, {3, 17}), 4);
+    YADI_ASSERT_EQ(false, result.ok());
+    YADI_ASSERT_EQ(2u, result.errors.size());
+    YADI_ASSERT_EQ(3u, result.errors[0].index);
+    YADI_ASSERT_EQ(17u, result.errors[1].index);
+    YADI_ASSERT_NE(std::string::npos, result.errors[0].message.find("Negative id"));
+    YADI_ASSERT_EQ(false, result.values[3].has_value());
+    YADI_ASSERT_EQ(4, (*result.values[4])->id);
+
+    std::vector<std::unique_ptr<batch_service>> services;
+    try {
+        from_yamls_parallel<std::unique_ptr<batch_service>>(batch_configs(8, {5}), std::back_inserter(services));
+        return false;
+    } catch (batch_exception const& ex) {
+        YADI_ASSERT_EQ(1u, ex.errors().size());
+        YADI_ASSERT_EQ(5u, ex.errors()[0].index);
+    }
+    YADI_ASSERT_EQ(0u, services.size());
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
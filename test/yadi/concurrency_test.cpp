@@ -0,0 +1,75 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct concurrent_type {
+    int value;
+};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<concurrent_type> {
+    using ptr_type = concurrent_type;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+YADI_TEST(concurrent_register_create_test) {
+    constexpr int TYPE_COUNT = 2000;
+    constexpr int READER_COUNT = 4;
+
+    ::yadi::register_type<concurrent_type>("stable", [](YAML::Node const&) { return concurrent_type{-1}; });
+
+    std::atomic<int> registered{0};
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < READER_COUNT; ++r) {
+        readers.emplace_back([&registered, &done, &failures, r]() {
+            for (int i = r; !done.load(); ++i) {
+                if (factory<concurrent_type>::create("stable").value != -1) {
+                    ++failures;
+                }
+
+                // Every type published so far must be found and build the right value
+                int const count = registered.load();
+                if (count > 0) {
+                    int const index = i % count;
+                    if (factory<concurrent_type>::create("type_" + std::to_string(index)).value != index) {
+                        ++failures;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < TYPE_COUNT; ++i) {
+        ::yadi::register_type<concurrent_type>("type_" + std::to_string(i), [i](YAML::Node const&) {
+            return concurrent_type{i};
+        });
+        // Re-registering swaps the value while readers use it
+        ::yadi::register_type<concurrent_type>("stable", [](YAML::Node const&) { return concurrent_type{-1}; });
+        registered.store(i + 1);
+    }
+    done.store(true);
+
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    YADI_ASSERT_EQ(0, failures.load());
+    YADI_ASSERT_EQ(TYPE_COUNT + 1u, factory<concurrent_type>::types().size());
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
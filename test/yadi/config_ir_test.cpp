@@ -0,0 +1,259 @@
+#include "test.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct ir_shape {
+    virtual ~ir_shape() = default;
+    virtual double area() const = 0;
+};
+
+struct ir_rect : public ir_shape {
+    ir_rect(double width, double height) : width(width), height(height) {}
+    double area() const override { return width * height; }
+    double width;
+    double height;
+};
+
+struct ir_square : public ir_shape {
+    explicit ir_square(double side) : side(side) {}
+    double area() const override { return side * side; }
+    double side;
+};
+
+struct ir_point : public ir_shape {
+    double area() const override { return 0; }
+};
+
+struct ir_bare : public ir_shape {
+    explicit ir_bare(YAML::Node const& config) : value(config["value"].as<double>()) {}
+    double area() const override { return value; }
+    double value;
+};
+
+ptr_type_t<ir_shape> make_rect(double width, double height) { return ctr<ir_shape, ir_rect>(width, height); }
+
+ptr_type_t<ir_shape> make_square(double side) { return ctr<ir_shape, ir_square>(side); }
+
+YADI_INIT_BEGIN
+::yadi::register_type<ir_shape>(
+    "rect", make_map_initializer_with_help<ir_shape>(&make_rect, std::vector<std::string>{"width", "height"}));
+::yadi::register_type<ir_shape>("square", make_sequence_initializer_with_help<ir_shape>(&make_square));
+::yadi::register_type_no_arg<ir_shape, ir_point>("point");
+::yadi::register_type<ir_shape, ir_bare>("bare");
+::yadi::register_alias<ir_shape>("wide", "rect", YAML::Load("{width: 10}"));
+YADI_INIT_END
+
+YADI_TEST(config_ir_node_test) {
+    config_document const document = config_document::load(R"raw(
+int: -42
+big: 18446744073709551615
+float: 2.5
+flag: yes
+text: hello
+tagged: !custom 7
+nothing: ~
+list: [1, two, 3.5]
+nested: {a: {b: [x]}}
+)raw");
+    config_node const root = document.root();
+    YADI_ASSERT_EQ(true, root.IsMap());
+    YADI_ASSERT_EQ(9u, root.size());
+
+    YADI_ASSERT_EQ(-42, root["int"].as<int>());
+    YADI_ASSERT_EQ(-42.0, root["int"].as<double>());
+    YADI_ASSERT_EQ(18446744073709551615ull, root["big"].as<unsigned long long>());
+    YADI_ASSERT_EQ(2.5, root["float"].as<double>());
+    YADI_ASSERT_EQ(2.5f, root["float"].as<float>());
+    YADI_ASSERT_EQ(true, root["flag"].as<bool>());
+    YADI_ASSERT_EQ(std::string("hello"), root["text"].as<std::string>());
+    YADI_ASSERT_EQ(std::string_view("!custom"), root["tagged"].Tag());
+    YADI_ASSERT_EQ(true, root["nothing"].IsNull());
+    YADI_ASSERT_EQ(false, root["missing"].IsDefined());
+    YADI_ASSERT_EQ(false, root["list"][3].IsDefined());
+    YADI_ASSERT_EQ(std::string_view("two"), root["list"][1].Scalar());
+    YADI_ASSERT_EQ(std::string_view("x"), root["nested"]["a"]["b"][0].Scalar());
+
+    // Conversions that don't fit fail the way yaml-cpp's do
+    for (char const* key : {"big", "text", "float"}) {
+        try {
+            root[key].as<int>();
+            return false;
+        } catch (YAML::BadConversion const&) {
+        }
+    }
+
+    // Converting back gives the same YAML
+    YADI_ASSERT_EQ(true, yaml_equal(YAML::Load(YAML::Dump(root.to_yaml())), root.to_yaml()));
+    YADI_ASSERT_EQ(7, root.to_yaml()["tagged"].as<int>());
+    YADI_ASSERT_EQ(std::string("!custom"), root.to_yaml()["tagged"].Tag());
+
+    return true;
+}
+
+YADI_TEST(config_ir_large_map_test) {
+    YAML::Node yaml;
+    for (int i = 0; i < 100; ++i) {
+        yaml["key_" + std::to_string(i)] = i;
+    }
+    config_document const document(yaml);
+    for (int i = 0; i < 100; ++i) {
+        YADI_ASSERT_EQ(i, document.root()["key_" + std::to_string(i)].as<int>());
+    }
+    YADI_ASSERT_EQ(false, document.root()["key_100"].IsDefined());
+
+    // The first of repeated keys is used, as with YAML::Node
+    config_document const repeated = config_document::load("{a: 1, b: 2, c: 3, d: 4, e: 5, f: 6, g: 7, h: 8, a: 9}");
+    YADI_ASSERT_EQ(YAML::Load("{a: 1, a: 9}")["a"].as<int>(), repeated.root()["a"].as<int>());
+
+    return true;
+}
+
+YADI_TEST(config_ir_create_test) {
+    config_document const document = config_document::load(R"raw(
+- {type: rect, config: {width: 2, height: 3}}
+- {type: square, config: [4]}
+- point
+- {type: bare, config: {value: 5}}
+- {type: wide, config: {height: 2}}
+)raw");
+    std::vector<ptr_type_t<ir_shape>> shapes;
+    from_yamls<ptr_type_t<ir_shape>>(document.root(), std::back_inserter(shapes));
+    YADI_ASSERT_EQ(5u, shapes.size());
+    YADI_ASSERT_EQ(6.0, shapes[0]->area());
+    YADI_ASSERT_EQ(16.0, shapes[1]->area());
+    YADI_ASSERT_EQ(0.0, shapes[2]->area());
+    YADI_ASSERT_EQ(5.0, shapes[3]->area());
+    YADI_ASSERT_EQ(20.0, shapes[4]->area());
+
+    // The binding initializers read the document without converting it
+    YADI_ASSERT_EQ(true, bool(factory<ir_shape>::find("rect")->config_initializer));
+    YADI_ASSERT_EQ(true, bool(factory<ir_shape>::find("square")->config_initializer));
+    YADI_ASSERT_EQ(false, bool(factory<ir_shape>::find("bare")->config_initializer));
+
+    config_document const containers = config_document::load(R"raw(
+ints: [1, 2, 3]
+names: {b: x, a: y}
+)raw");
+    YADI_ASSERT_EQ((std::vector<int>{1, 2, 3}), from_yaml<std::vector<int>>(containers.root()["ints"]));
+    YADI_ASSERT_EQ((std::set<int>{1, 2, 3}), from_yaml<std::set<int>>(containers.root()["ints"]));
+    YADI_ASSERT_EQ((std::map<std::string, std::string>{{"a", "y"}, {"b", "x"}}),
+                   (from_yaml<std::map<std::string, std::string>>(containers.root()["names"])));
+
+    return true;
+}
+
+YADI_TEST(config_ir_error_test) {
+    // Errors read the same as creating from YAML
+    for (std::string const config : {"{type: rect, config: {width: 2, depth: 3}}", "{type: rect, config: {width: x}}",
+                                      "{type: missing}", "[]"}) {
+        std::string yaml_error;
+        std::string ir_error;
+        try {
+            from_yaml<ptr_type_t<ir_shape>>(YAML::Load(config));
+        } catch (std::exception const& ex) {
+            yaml_error = ex.what();
+        }
+        try {
+            from_yaml<ptr_type_t<ir_shape>>(config_document::load(config).root());
+        } catch (std::exception const& ex) {
+            ir_error = ex.what();
+        }
+        YADI_ASSERT_NE(std::string(), ir_error);
+        YADI_ASSERT_EQ(yaml_error, ir_error);
+    }
+
+    return true;
+}
+
+YADI_TEST(config_ir_file_test) {
+    std::string const yaml = "[{type: rect, config: {width: 2, height: 3}}, {type: square, config: [4]}]";
+    std::string const path = "config_ir_file_test.yadicfg";
+    {
+        std::ofstream out(path, std::ios::binary);
+        config_document::load(yaml).save(out);
+    }
+    {
+        config_document const mapped = config_document::map_file(path);
+        std::vector<ptr_type_t<ir_shape>> shapes;
+        from_yamls<ptr_type_t<ir_shape>>(mapped.root(), std::back_inserter(shapes));
+        YADI_ASSERT_EQ(2u, shapes.size());
+        YADI_ASSERT_EQ(6.0, shapes[0]->area());
+        YADI_ASSERT_EQ(16.0, shapes[1]->area());
+        YADI_ASSERT_EQ(true, yaml_equal(YAML::Load(yaml), mapped.root().to_yaml()));
+    }
+    std::remove(path.c_str());
+
+    try {
+        config_document::map_file(path);
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    // A file whose string lookup table has no empty slot is rejected on load rather than looping on lookup
+    {
+        config_document const document = config_document::load(yaml);
+        std::string bytes(static_cast<char const*>(document.data()), document.size());
+        details::config_header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        std::vector<std::uint32_t> const slots(header.string_slot_count, 1);
+        std::memcpy(&bytes[header.string_slots_offset], slots.data(), slots.size() * sizeof(std::uint32_t));
+        std::ofstream(path, std::ios::binary) << bytes;
+    }
+    try {
+        config_document::map_file(path);
+        return false;
+    } catch (std::runtime_error const& ex) {
+        YADI_ASSERT_NE(std::string::npos, std::string(ex.what()).find("Invalid config buffer"));
+    }
+    std::remove(path.c_str());
+
+    return true;
+}
+
+YADI_TEST(config_ir_buffer_validation_test) {
+    config_document const document = config_document::load("{a: [1, 2], b: {c: d}}");
+    auto copy = [&document]() {
+        std::shared_ptr<std::uint64_t> buffer(new std::uint64_t[(document.size() + 7) / 8](),
+                                              std::default_delete<std::uint64_t[]>());
+        std::memcpy(buffer.get(), document.data(), document.size());
+        return buffer;
+    };
+    auto rejected = [](std::shared_ptr<std::uint64_t> const& buffer, std::size_t size) {
+        try {
+            config_document::from_buffer(buffer, size);
+            return false;
+        } catch (std::runtime_error const&) {
+            return true;
+        }
+    };
+
+    YADI_ASSERT_EQ(2, config_document::from_buffer(copy(), document.size()).root()["a"][1].as<int>());
+    YADI_ASSERT_EQ(true, rejected(copy(), document.size() - 1));
+    YADI_ASSERT_EQ(true, rejected(copy(), 16));
+
+    // Any single corrupted word after the magic is either rejected or still reads within the buffer
+    for (std::size_t word = 1; word < document.size() / 8; ++word) {
+        std::shared_ptr<std::uint64_t> const buffer = copy();
+        buffer.get()[word] ^= 0xffffffffull;
+        try {
+            YAML::Node const yaml = config_document::from_buffer(buffer, document.size()).root().to_yaml();
+            std::ostringstream out;
+            out << yaml;
+        } catch (std::runtime_error const&) {
+        }
+    }
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
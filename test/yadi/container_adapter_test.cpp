@@ -0,0 +1,180 @@
+#include "test.hpp"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace yadi {
+
+enum class container_key { low = 1, high = 2 };
+
+// By value with an initializer of its own, so sequences of it can't be read in bulk
+template <>
+struct factory_traits<long double> {
+    using ptr_type = long double;
+    static constexpr bool direct_from_yaml = true;
+};
+
+YADI_INIT_BEGIN
+::yadi::register_type<long double>(::yadi::type_by_value_key(),
+                                   [](YAML::Node const& config) { return 2 * config.as<long double>(); });
+YADI_INIT_END
+
+namespace {
+
+YADI_TEST(container_array_test) {
+    YADI_ASSERT_EQ((std::array<int, 3>{1, 2, 3}), (from_yaml<std::array<int, 3>>(YAML::Load("[1, 2, 3]"))));
+    YADI_ASSERT_EQ((std::array<std::string, 2>{"a", "b"}),
+                   (from_yaml<std::array<std::string, 2>>(config_document::load("[a, b]").root())));
+    YADI_ASSERT_EQ("array<" + std::string(adapter<int>::get_name()) + ", 3>",
+                   (adapter<std::array<int, 3>>::get_name()));
+
+    for (char const* config : {"[1, 2]", "[1, 2, 3, 4]", "{a: 1}"}) {
+        try {
+            from_yaml<std::array<int, 3>>(YAML::Load(config));
+            return false;
+        } catch (std::runtime_error const&) {
+        }
+    }
+
+    return true;
+}
+
+YADI_TEST(container_deque_test) {
+    YADI_ASSERT_EQ((std::deque<std::string>{"a", "b"}), from_yaml<std::deque<std::string>>(YAML::Load("[a, b]")));
+    YADI_ASSERT_EQ((std::deque<int>{4}), from_yaml<std::deque<int>>(YAML::Load("4")));
+
+    return true;
+}
+
+YADI_TEST(container_flat_test) {
+    flat_set<int> const set = from_yaml<flat_set<int>>(YAML::Load("[3, 1, 2, 1]"));
+    YADI_ASSERT_EQ((std::vector<int>{1, 2, 3}), set.sequence());
+    YADI_ASSERT_EQ(true, set.contains(2));
+    YADI_ASSERT_EQ(false, set.contains(4));
+
+    // Repeated keys keep the last value, as std::map does
+    YAML::Node const config = YAML::Load("{b: 2, a: 1, c: 3, a: 4}");
+    flat_map<std::string, int> const map = from_yaml<flat_map<std::string, int>>(config);
+    YADI_ASSERT_EQ(3u, map.size());
+    YADI_ASSERT_EQ(4, map.at("a"));
+    YADI_ASSERT_EQ(3, map.at("c"));
+    YADI_ASSERT_EQ(map.end(), map.find("d"));
+    YADI_ASSERT_EQ(std::string("a"), map.begin()->first);
+    std::map<std::string, int> const tree = from_yaml<std::map<std::string, int>>(config);
+    YADI_ASSERT_EQ(tree.size(), map.size());
+    YADI_ASSERT_EQ(tree.at("a"), map.at("a"));
+
+    flat_map<int, std::string> const numbered =
+        from_yaml<flat_map<int, std::string>>(config_document::load("{10: ten, 2: two}").root());
+    YADI_ASSERT_EQ(2, numbered.begin()->first);
+    YADI_ASSERT_EQ(std::string("ten"), numbered.at(10));
+
+    flat_map<int, std::string> edited = numbered;
+    YADI_ASSERT_EQ(true, edited.insert_or_assign(5, "five").second);
+    YADI_ASSERT_EQ(false, edited.insert_or_assign(10, "TEN").second);
+    YADI_ASSERT_EQ((std::vector<int>{2, 5, 10}), (std::vector<int>{edited.sequence()[0].first,
+                                                                    edited.sequence()[1].first,
+                                                                    edited.sequence()[2].first}));
+
+    return true;
+}
+
+YADI_TEST(container_map_key_test) {
+    std::map<int, std::string> const ints = from_yaml<std::map<int, std::string>>(YAML::Load("{3: c, -1: a, 0x10: x}"));
+    YADI_ASSERT_EQ((std::map<int, std::string>{{-1, "a"}, {3, "c"}, {16, "x"}}), ints);
+    // A leading 0 is octal, as yaml-cpp reads it
+    YADI_ASSERT_EQ(8, (from_yaml<std::map<int, int>>(YAML::Load("{010: 1}")).begin()->first));
+
+    std::unordered_map<std::uint8_t, int> const bytes =
+        from_yaml<std::unordered_map<std::uint8_t, int>>(config_document::load("{7: 1, 255: 2}").root());
+    YADI_ASSERT_EQ(2, bytes.at(255));
+
+    std::map<container_key, int> const keys = from_yaml<std::map<container_key, int>>(YAML::Load("{1: 10, 2: 20}"));
+    YADI_ASSERT_EQ(20, keys.at(container_key::high));
+
+    // Characters, not their numeric values, as yaml-cpp reads them
+    YAML::Node const chars_config = YAML::Load("{'7': 1, 'A': 2}");
+    std::map<char, int> const chars = from_yaml<std::map<char, int>>(chars_config);
+    YADI_ASSERT_EQ((std::map<char, int>{{'7', 1}, {'A', 2}}), chars);
+    YADI_ASSERT_EQ((chars_config.as<std::map<char, int>>()), chars);
+
+    std::map<double, int> const doubles = from_yaml<std::map<double, int>>(YAML::Load("{0.5: 1}"));
+    YADI_ASSERT_EQ(1, doubles.at(0.5));
+
+    try {
+        from_yaml<std::map<int, int>>(YAML::Load("{x: 1}"));
+        return false;
+    } catch (std::exception const&) {
+    }
+
+    // Keys that aren't scalars fail rather than reading as ""
+    for (char const* config : {"{[a]: 1, {b: c}: 2}", "{[1]: 1}"}) {
+        try {
+            from_yaml<std::map<std::string, int>>(YAML::Load(config));
+            return false;
+        } catch (std::exception const&) {
+        }
+        try {
+            from_yaml<flat_map<int, int>>(YAML::Load(config));
+            return false;
+        } catch (std::exception const&) {
+        }
+    }
+
+    return true;
+}
+
+YADI_TEST(container_numbers_test) {
+    YADI_ASSERT_EQ((std::vector<double>{1.5, -2, 3e3}), from_yaml<std::vector<double>>(YAML::Load("[1.5, -2, 3e3]")));
+    YADI_ASSERT_EQ((std::vector<std::int32_t>{1, 2}),
+                   from_yaml<std::vector<std::int32_t>>(config_document::load("[1, 2]").root()));
+    YADI_ASSERT_EQ((std::set<int>{1, 2}), from_yaml<std::set<int>>(YAML::Load("[2, 1, 2]")));
+    // Forms from_chars doesn't read the same are converted by yaml-cpp
+    YADI_ASSERT_EQ((std::vector<int>{16, 5, 8}), from_yaml<std::vector<int>>(YAML::Load("[0x10, +5, 010]")));
+    std::vector<double> const special = from_yaml<std::vector<double>>(YAML::Load("[.inf, -.inf, .5, 1e2]"));
+    YADI_ASSERT_EQ((std::vector<double>{std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity(), 0.5, 100}),
+                   special);
+
+    // Numbers are read without a create per element, unless their initializer isn't the stock one
+    YADI_ASSERT_EQ((std::vector<double>{1, 2, 3}), from_yaml<std::vector<double>>(YAML::Load("[1, 2, 3]")));
+    YADI_ASSERT_EQ((std::vector<long double>{2, 4, 6}), from_yaml<std::vector<long double>>(YAML::Load("[1, 2, 3]")));
+
+    // While traced every element is created, and traced, through its factory
+    chrome_trace_sink sink;
+    set_trace_sink(&sink);
+    std::vector<double> const doubles = from_yaml<std::vector<double>>(YAML::Load("[1, 2, 3]"));
+    set_trace_sink(nullptr);
+    YADI_ASSERT_EQ((std::vector<double>{1, 2, 3}), doubles);
+    std::size_t creates = 0;
+    for (trace_record const& record : sink.records()) {
+        if (record.kind == trace_kind::create && record.phase == trace_phase::begin) {
+            YADI_ASSERT_EQ(demangle_type<double>(), record.factory);
+            ++creates;
+        }
+    }
+    YADI_ASSERT_EQ(3u, creates);
+
+    // Errors are the same as creating each element
+    YAML::Node const invalid = YAML::Load("[1, x, 3]");
+    std::vector<int> ignored;
+    std::string const expected = try_from_yamls<int>(invalid, std::back_inserter(ignored)).error().message();
+    try {
+        from_yaml<std::vector<int>>(invalid);
+        return false;
+    } catch (std::runtime_error const& ex) {
+        YADI_ASSERT_EQ(expected, std::string(ex.what()));
+    }
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
@@ -0,0 +1,70 @@
+#include "test.hpp"
+
+#include <set>
+
+namespace yadi {
+namespace {
+
+struct frozen_base {
+    virtual ~frozen_base() {}
+    virtual int value() const = 0;
+};
+
+template <int VALUE>
+struct frozen_impl : public frozen_base {
+    int value() const override { return VALUE; }
+};
+
+YADI_INIT_BEGIN
+register_type_no_arg<frozen_base, frozen_impl<1>>("one");
+register_type_no_arg<frozen_base, frozen_impl<2>>("two");
+register_type_no_arg<frozen_base, frozen_impl<3>>("three");
+YADI_INIT_END
+
+YADI_TEST(perfect_hash_test) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; ++i) {
+        names.push_back("type_" + std::to_string(i));
+    }
+    std::vector<std::string_view> keys{names.begin(), names.end()};
+
+    details::perfect_hash hash(keys);
+    std::set<std::size_t> slots;
+    for (std::string_view key : keys) {
+        std::size_t slot = hash.slot(key);
+        YADI_ASSERT_EQ(true, (slot < hash.slot_count()));
+        slots.insert(slot);
+    }
+    YADI_ASSERT_EQ(keys.size(), slots.size());
+
+    return true;
+}
+
+YADI_TEST(freeze_test) {
+    YADI_ASSERT_EQ(false, factory<frozen_base>::frozen());
+    factory<frozen_base>::freeze();
+    YADI_ASSERT_EQ(true, factory<frozen_base>::frozen());
+    factory<frozen_base>::freeze();
+
+    YADI_ASSERT_EQ(1, factory<frozen_base>::create("one")->value());
+    YADI_ASSERT_EQ(2, factory<frozen_base>::create("two")->value());
+    YADI_ASSERT_EQ(3, factory<frozen_base>::create("three")->value());
+    YADI_ASSERT_EQ(3, from_yaml<std::unique_ptr<frozen_base>>(YAML::Load("three"))->value());
+
+    try {
+        factory<frozen_base>::create("four");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    try {
+        register_type_no_arg<frozen_base, frozen_impl<4>>("four");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
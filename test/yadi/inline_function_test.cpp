@@ -0,0 +1,94 @@
+#include "test.hpp"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace yadi {
+namespace {
+
+using int_function = details::inline_function<int(int const&)>;
+
+int twice(int const& value) { return value * 2; }
+
+struct wrapped_value {
+    int value;
+};
+
+YADI_TEST(inline_function_test) {
+    int_function empty;
+    YADI_ASSERT_EQ(false, bool(empty));
+    YADI_ASSERT_EQ(false, bool(int_function(nullptr)));
+    YADI_ASSERT_EQ(false, bool(int_function(static_cast<int (*)(int const&)>(nullptr))));
+    // Empty wrappers are empty, as they are for std::function
+    YADI_ASSERT_EQ(false, bool(int_function(std::function<int(int const&)>())));
+    YADI_ASSERT_EQ(false, bool(int_function(details::inline_function<int(int const&), 16>())));
+    YADI_ASSERT_EQ(true, bool(int_function(std::function<int(int const&)>(&twice))));
+    try {
+        empty(1);
+        return false;
+    } catch (std::bad_function_call const&) {
+    }
+
+    int_function pointer = &twice;
+    YADI_ASSERT_EQ(6, pointer(3));
+    using pointer_type = int (*)(int const&);
+    YADI_ASSERT_EQ(&twice, *pointer.target<pointer_type>());
+    YADI_ASSERT_EQ(true, (empty.target<pointer_type>() == nullptr));
+
+    // Captures that don't fit are allocated, both kinds copy and move the same way
+    auto counter = std::make_shared<int>(0);
+    std::array<int, 32> large{};
+    large[31] = 10;
+    int_function small_capture = [counter](int const& value) { return ++*counter + value; };
+    int_function large_capture = [counter, large](int const& value) { return ++*counter + value + large[31]; };
+    YADI_ASSERT_EQ(3, counter.use_count());
+    YADI_ASSERT_EQ(true, (small_capture.target<pointer_type>() == nullptr));
+
+    for (int_function* func : {&small_capture, &large_capture}) {
+        int_function copy = *func;
+        YADI_ASSERT_EQ(4, counter.use_count());
+        int_function moved = std::move(copy);
+        YADI_ASSERT_EQ(false, bool(copy));
+        YADI_ASSERT_EQ(4, counter.use_count());
+        moved = *func;
+        moved = pointer;
+        YADI_ASSERT_EQ(3, counter.use_count());
+        YADI_ASSERT_EQ(8, moved(4));
+        moved = std::move(*func);
+        YADI_ASSERT_EQ(3, counter.use_count());
+        *func = std::move(moved);
+    }
+    YADI_ASSERT_EQ(1, small_capture(0));
+    YADI_ASSERT_EQ(12, large_capture(0));
+
+    small_capture = nullptr;
+    large_capture = nullptr;
+    YADI_ASSERT_EQ(1, counter.use_count());
+
+    // Mutable callables keep their state, as with std::function
+    int_function accumulate = [total = 0](int const& value) mutable { return total += value; };
+    accumulate(2);
+    YADI_ASSERT_EQ(5, accumulate(3));
+
+    // Any callable whose result converts
+    details::inline_function<std::string(int const&)> to_string = [](int value) { return std::to_string(value); };
+    YADI_ASSERT_EQ(std::string("7"), to_string(7));
+
+    return true;
+}
+
+YADI_TEST(inline_function_empty_config_initializer_test) {
+    // An empty std::function config_initializer leaves creates to the initializer
+    using wrapped_ptr = ptr_type_t<wrapped_value>;
+    ::yadi::register_type<wrapped_value>(
+        "wrapped", {[](YAML::Node const& config) { return wrapped_ptr(new wrapped_value{config.as<int>()}); },
+                    "Wraps an int", std::function<wrapped_ptr(config_node const&)>()});
+    YADI_ASSERT_EQ(5, factory<wrapped_value>::create("wrapped", config_document::load("5").root())->value);
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
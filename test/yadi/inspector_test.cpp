@@ -12,4 +12,19 @@ YADI_TEST(inspector_test) {
     ::yadi::print_factory_help(std::cout);
 
     return true;
-}
\ No newline at end of file
+}
+
+YADI_TEST(validate_config_test) {
+    YAML::Node const config = YAML::Load("{a: {type: gas}, b: [{type: not_registered}, {type: [x]}]}");
+    std::vector<std::string> const errors = ::yadi::validate_config(config);
+    YADI_ASSERT_EQ(1u, errors.size());
+    YADI_ASSERT_EQ(std::string("Unknown type \"not_registered\" at line 1, column 29"), errors[0]);
+
+    // Only type where a create is expected, data with a type field is left alone
+    YAML::Node const data = YAML::Load("{part: {name: a, type: fixed}, nested: {type: gas, config: {type: nope}}}");
+    std::vector<std::string> const data_errors = ::yadi::validate_config(data);
+    YADI_ASSERT_EQ(1u, data_errors.size());
+    YADI_ASSERT_EQ(0u, data_errors[0].find("Unknown type \"nope\""));
+
+    return true;
+}
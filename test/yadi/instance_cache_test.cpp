@@ -0,0 +1,76 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct cached_service {
+    explicit cached_service(int id) : id(id) {}
+    int id;
+};
+
+YADI_TEST(instance_cache_single_flight_test) {
+    details::instance_cache<cached_service, std::string> cache;
+    std::atomic<int> creations{0};
+
+    std::vector<std::shared_ptr<cached_service>> instances(8);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < instances.size(); ++t) {
+        threads.emplace_back([&cache, &creations, &instances, t]() {
+            instances[t] = cache.get_or_create("service", [&creations]() {
+                // Stay in the create long enough for the other threads to miss as well
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                return std::make_shared<cached_service>(++creations);
+            });
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    YADI_ASSERT_EQ(1, creations.load());
+    for (auto const& instance : instances) {
+        YADI_ASSERT_EQ(instances.front(), instance);
+    }
+
+    return true;
+}
+
+YADI_TEST(instance_cache_error_test) {
+    details::instance_cache<cached_service, std::string> cache;
+    try {
+        cache.get_or_create("service", []() -> std::shared_ptr<cached_service> { throw std::runtime_error("boom"); });
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    // A failed creation isn't cached
+    auto instance = cache.get_or_create("service", []() { return std::make_shared<cached_service>(5); });
+    YADI_ASSERT_EQ(5, instance->id);
+
+    return true;
+}
+
+YADI_TEST(instance_cache_purge_test) {
+    details::instance_cache<cached_service, std::string> cache(1);
+    auto live = cache.get_or_create("live", []() { return std::make_shared<cached_service>(-1); });
+
+    // None of these instances are held, so their entries are swept as the cache grows
+    for (int i = 0; i < 1000; ++i) {
+        cache.get_or_create(std::to_string(i), [i]() { return std::make_shared<cached_service>(i); });
+    }
+    YADI_ASSERT_EQ(true, (cache.size() < 100u));
+
+    cache.purge();
+    YADI_ASSERT_EQ(1u, cache.size());
+    YADI_ASSERT_EQ(live, cache.get_or_create("live", []() { return std::make_shared<cached_service>(-2); }));
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
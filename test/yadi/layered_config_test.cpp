@@ -0,0 +1,90 @@
+#include "test.hpp"
+
+namespace yadi {
+namespace {
+
+YADI_TEST(layered_config_test) {
+    YAML::Node const defaults = YAML::Load("{a: 1, b: 1, table: {x: 1, y: 1}}");
+    YAML::Node const passed = YAML::Load("{b: 2, table: {y: 2}}");
+
+    layered_config shallow(passed);
+    shallow.under(defaults);
+    YADI_ASSERT_EQ(1, shallow["a"].as<int>());
+    YADI_ASSERT_EQ(2, shallow["b"].as<int>());
+    YADI_ASSERT_EQ(false, shallow["table"]["x"].defined());
+    YADI_ASSERT_EQ(2, shallow["table"]["y"].as<int>());
+    YADI_ASSERT_EQ(false, shallow["missing"].defined());
+
+    layered_config deep(passed, merge_mode::deep);
+    deep.under(defaults);
+    YADI_ASSERT_EQ(1, deep["table"]["x"].as<int>());
+    YADI_ASSERT_EQ(2, deep["table"]["y"].as<int>());
+
+    // A lookup reaching a single layer doesn't copy it
+    YADI_ASSERT_EQ(true, deep["a"].node().is(defaults["a"]));
+    YADI_ASSERT_EQ(true, layered_config(passed).under(YAML::Node()).node().is(passed));
+
+    YAML::Node const merged = deep.node();
+    YADI_ASSERT_EQ(3u, merged.size());
+    YADI_ASSERT_EQ(1, merged["table"]["x"].as<int>());
+    YADI_ASSERT_EQ(2, merged["table"]["y"].as<int>());
+    YADI_ASSERT_EQ(2u, merged["table"].size());
+
+    return true;
+}
+
+YADI_TEST(merge_yaml_test) {
+    YAML::Node const left = YAML::Load("{a: 1, b: 1, table: {x: 1}}");
+    YAML::Node const right = YAML::Load("{b: 2, table: {y: 2}}");
+
+    YAML::Node const shallow = merge_yaml(left, right);
+    YADI_ASSERT_EQ(3u, shallow.size());
+    YADI_ASSERT_EQ(2, shallow["b"].as<int>());
+    YADI_ASSERT_EQ(false, shallow["table"]["x"].IsDefined());
+    // Overridden entries are dropped rather than repeated, so map conversion agrees with lookup
+    YADI_ASSERT_EQ(2, (shallow.as<std::map<std::string, YAML::Node>>()["b"].as<int>()));
+
+    YAML::Node const deep = merge_yaml(left, right, merge_mode::deep);
+    YADI_ASSERT_EQ(1, deep["table"]["x"].as<int>());
+    YADI_ASSERT_EQ(2, deep["table"]["y"].as<int>());
+
+    // The merge copies, changing it leaves the inputs alone
+    YAML::Node copy = deep;
+    copy["table"]["x"] = 5;
+    YADI_ASSERT_EQ(1, left["table"]["x"].as<int>());
+
+    // A value which isn't a map is hidden by a map above it, along with anything below it
+    YAML::Node const shadowed = merge_yaml(YAML::Load("{t: 5, a: 1}"), YAML::Load("{t: {x: 1}}"), merge_mode::deep);
+    YADI_ASSERT_EQ(1, shadowed["t"]["x"].as<int>());
+    YADI_ASSERT_EQ(1, shadowed["a"].as<int>());
+    YADI_ASSERT_EQ(5, merge_yaml(YAML::Load("{t: {x: 1}}"), YAML::Load("{t: 5}"), merge_mode::deep)["t"].as<int>());
+    layered_config layers(YAML::Load("{t: {x: 1}}"), merge_mode::deep);
+    layers.under(YAML::Load("{t: 5}")).under(YAML::Load("{t: {y: 2}}"));
+    YADI_ASSERT_EQ(1u, layers.node()["t"].size());
+
+    YADI_ASSERT_EQ(true, merge_yaml(left, YAML::Node()).is(left));
+    YADI_ASSERT_EQ(true, merge_yaml(YAML::Load("~"), right).is(right));
+    try {
+        merge_yaml(left, YAML::Load("scalar"));
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    return true;
+}
+
+YADI_TEST(alias_deep_merge_test) {
+    ::yadi::register_type<YAML::Node, YAML::Node>("deep_base");
+    register_alias<YAML::Node>("deep1", "deep_base", YAML::Load("{routes: {a: 1, b: 1}}"), merge_mode::deep);
+    register_alias<YAML::Node>("deep2", "deep1", YAML::Load("{routes: {b: 2}}"), merge_mode::deep);
+
+    YAML::Node const config = factory<YAML::Node>::create("deep2", YAML::Load("{routes: {c: 3}}"));
+    YADI_ASSERT_EQ(1, config["routes"]["a"].as<int>());
+    YADI_ASSERT_EQ(2, config["routes"]["b"].as<int>());
+    YADI_ASSERT_EQ(3, config["routes"]["c"].as<int>());
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
@@ -0,0 +1,82 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct lazy_widget {
+    std::string name;
+    int count;
+};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<lazy_widget> {
+    using ptr_type = lazy_widget;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+std::atomic<int> BUILDS{0};
+
+lazy_widget make_lazy_widget(std::string name, int count) { return lazy_widget{std::move(name), count}; }
+
+yadi_info_t<lazy_widget> build_lazy_widget() {
+    ++BUILDS;
+    return make_map_initializer_with_help<lazy_widget>(&make_lazy_widget, std::vector<std::string>{"name", "count"});
+}
+
+YADI_INIT_BEGIN
+::yadi::register_type_lazy<lazy_widget>("widget", &build_lazy_widget);
+::yadi::register_type_lazy<lazy_widget>("unused", &build_lazy_widget);
+::yadi::register_type_lazy<lazy_widget>("throwing", []() -> yadi_info_t<lazy_widget> {
+    throw std::runtime_error("Not built");
+});
+YADI_INIT_END
+
+YADI_TEST(lazy_registration_test) {
+    // Nothing is built by registering
+    YADI_ASSERT_EQ(0, BUILDS.load());
+    YADI_ASSERT_NE(nullptr, factory<lazy_widget>::find("widget"));
+    YADI_ASSERT_EQ(0, BUILDS.load());
+
+    // Built once on first use, even when first used from several threads
+    YAML::Node const config = YAML::Load("{name: a, count: 2}");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&config]() { factory<lazy_widget>::create("widget", config); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    YADI_ASSERT_EQ(1, BUILDS.load());
+    YADI_ASSERT_EQ(2, factory<lazy_widget>::create("widget", config).count);
+    config_document const document = config_document::load("{name: b, count: 3}");
+    YADI_ASSERT_EQ(std::string("b"), factory<lazy_widget>::create("widget", document.root()).name);
+
+    // Help is built too
+    YADI_ASSERT_EQ(0u, factory<lazy_widget>::find("widget")->get_help().find("Expects yaml map with fields:"));
+    YADI_ASSERT_EQ(1, BUILDS.load());
+    YADI_ASSERT_NE(std::string(), factory<lazy_widget>::find("unused")->get_help());
+    YADI_ASSERT_EQ(2, BUILDS.load());
+
+    // A failed build is reported by create and tried again next time
+    for (int i = 0; i < 2; ++i) {
+        try {
+            factory<lazy_widget>::create("throwing");
+            return false;
+        } catch (std::runtime_error const& ex) {
+            YADI_ASSERT_EQ(std::string("Error creating \"throwing\": Not built"), std::string(ex.what()));
+        }
+    }
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
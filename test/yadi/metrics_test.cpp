@@ -0,0 +1,136 @@
+#include "test.hpp"
+
+#include <yadi/inspector.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct metered {
+    virtual ~metered() = default;
+};
+
+struct metered_impl : public metered {
+    explicit metered_impl(YAML::Node const& config) {
+        if (config.IsScalar() && config.as<std::string>() == "fail") {
+            throw std::runtime_error("failed");
+        }
+    }
+    char payload[40];
+};
+
+YADI_INIT_BEGIN
+::yadi::register_type<metered, metered_impl>("meter");
+YADI_INIT_END
+
+create_metrics sample_metrics() {
+    create_metrics metrics;
+    metrics.factory = "shape";
+    metrics.type = "rect";
+    metrics.creates = 4;
+    metrics.failures = 1;
+    metrics.nanoseconds = 400;
+    metrics.bytes = 64;
+    metrics.latency[6] = 3;  // Under 128 ns
+    metrics.latency[8] = 1;  // Under 512 ns
+    return metrics;
+}
+
+YADI_TEST(metrics_format_test) {
+    create_metrics const metrics = sample_metrics();
+    YADI_ASSERT_EQ(128u, metrics.latency_percentile(0.5));
+    YADI_ASSERT_EQ(512u, metrics.latency_percentile(0.99));
+    YADI_ASSERT_EQ(0u, create_metrics().latency_percentile(0.5));
+
+    std::ostringstream text;
+    print_create_metrics(text, {metrics});
+    YADI_ASSERT_EQ(std::string("shape\n\t\"rect\" -> 4 creates, 1 failed, mean 100 ns, p50 < 128 ns, p99 < 512 ns, "
+                               "64 bytes\n"),
+                   text.str());
+
+    std::ostringstream json;
+    print_create_metrics(json, {metrics}, metrics_format::json);
+    YADI_ASSERT_EQ(std::string("{\n  \"metrics\": [\n    {\"factory\": \"shape\", \"type\": \"rect\", \"creates\": 4, "
+                               "\"failures\": 1, \"nanoseconds\": 400, \"bytes\": 64, \"latency\": [{\"below_ns\": "
+                               "128, \"count\": 3}, {\"below_ns\": 512, \"count\": 1}]}\n  ]\n}\n"),
+                   json.str());
+
+    std::ostringstream empty;
+    print_create_metrics(empty, {}, metrics_format::json);
+    YADI_ASSERT_EQ(std::string("{\n  \"metrics\": []\n}\n"), empty.str());
+
+    return true;
+}
+
+#ifdef YADI_INSTRUMENT
+
+create_metrics metrics_of(std::string_view factory, std::string const& type) {
+    std::vector<create_metrics> const snapshot = create_metrics_snapshot();
+    auto const found = std::find_if(snapshot.begin(), snapshot.end(), [&](create_metrics const& metrics) {
+        return metrics.factory == factory && metrics.type == type;
+    });
+    return found == snapshot.end() ? create_metrics() : *found;
+}
+
+create_metrics meter_metrics() { return metrics_of(demangle_type<metered>(), "meter"); }
+
+YADI_TEST(metrics_instrumented_test) {
+    reset_create_metrics();
+    YADI_ASSERT_EQ(0u, meter_metrics().creates);
+
+    factory<metered>::create("meter");
+    factory<metered>::try_create("meter", YAML::Load("fail"));
+    try {
+        factory<metered>::create("meter", YAML::Load("fail"));
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+    // Counts of a thread that has exited are kept
+    std::thread([] { factory<metered>::create("meter"); }).join();
+
+    create_metrics const metrics = meter_metrics();
+    YADI_ASSERT_EQ(demangle_type<metered>(), metrics.factory);
+    YADI_ASSERT_EQ(4u, metrics.creates);
+    YADI_ASSERT_EQ(2u, metrics.failures);
+    // The object is allocated before its constructor throws
+    YADI_ASSERT_EQ(4 * sizeof(metered_impl), metrics.bytes);
+    std::uint64_t bucketed = 0;
+    for (std::uint64_t count : metrics.latency) {
+        bucketed += count;
+    }
+    YADI_ASSERT_EQ(4u, bucketed);
+
+    reset_create_metrics();
+    YADI_ASSERT_EQ(0u, meter_metrics().creates);
+    factory<metered>::create("meter");
+    YADI_ASSERT_EQ(1u, meter_metrics().creates);
+
+    // Scalars by value are created through their factory too
+    from_yaml<int>(YAML::Load("5"));
+    YADI_ASSERT_EQ(1u, metrics_of(demangle_type<int>(), type_by_value_key()).creates);
+    from_yaml<std::vector<int>>(YAML::Load("[1, 2]"));
+    YADI_ASSERT_EQ(3u, metrics_of(demangle_type<int>(), type_by_value_key()).creates);
+
+    return true;
+}
+
+#else
+
+YADI_TEST(metrics_disabled_test) {
+    factory<metered>::create("meter");
+    YADI_ASSERT_EQ(true, create_metrics_snapshot().empty());
+
+    return true;
+}
+
+#endif  // YADI_INSTRUMENT
+
+}  // anonymous namespace
+}  // namespace yadi
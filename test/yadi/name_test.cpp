@@ -0,0 +1,49 @@
+#include "test.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct named_widget {};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<named_widget> {
+    using ptr_type = named_widget;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+YADI_TEST(name_cache_test) {
+    // Demangled once, later calls view the same string
+    std::string_view const demangled = demangle_type<named_widget>();
+    YADI_ASSERT_EQ(std::string("yadi::(anonymous namespace)::named_widget"), std::string(demangled));
+    YADI_ASSERT_EQ(static_cast<void const*>(demangled.data()),
+                   static_cast<void const*>(demangle_type<named_widget>().data()));
+
+    std::string_view const name = yadi_help::get_name<named_widget>();
+    YADI_ASSERT_EQ(std::string(demangled), std::string(name));
+    YADI_ASSERT_EQ(static_cast<void const*>(name.data()),
+                   static_cast<void const*>(yadi_help::get_name<named_widget>().data()));
+
+    std::string_view const list_name = adapter<std::vector<named_widget>>::get_name();
+    YADI_ASSERT_EQ("list<" + std::string(demangled) + ">", std::string(list_name));
+    YADI_ASSERT_EQ(static_cast<void const*>(list_name.data()),
+                   static_cast<void const*>(adapter<std::vector<named_widget>>::get_name().data()));
+
+    // Registering a factory name replaces the cached names, views of the old ones stay valid
+    register_factory<named_widget>("widget");
+    YADI_ASSERT_EQ(std::string("widget"), std::string(yadi_help::get_name<named_widget>()));
+    YADI_ASSERT_EQ(std::string("list<widget>"), std::string(adapter<std::vector<named_widget>>::get_name()));
+    YADI_ASSERT_EQ("list<" + std::string(demangled) + ">", std::string(list_name));
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
@@ -0,0 +1,141 @@
+#include "test.hpp"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct strategy {
+    static int live;
+    strategy() { ++live; }
+    strategy(strategy const&) = delete;
+    virtual ~strategy() { --live; }
+    virtual int value() const = 0;
+};
+
+int strategy::live = 0;
+
+template <int VALUE>
+struct fixed_strategy : public strategy {
+    int value() const override { return VALUE; }
+};
+
+// The same strategies through each policy and pointer
+template <typename PT, typename AP>
+struct strategy_base : public strategy {};
+
+}  // anonymous namespace
+
+template <typename PT, typename AP>
+struct factory_traits<strategy_base<PT, AP>> {
+    using ptr_type = PT;
+    static constexpr bool direct_from_yaml = false;
+    using allocation = AP;
+};
+
+namespace {
+
+template <typename PT, typename AP>
+struct policy_strategy : public strategy_base<PT, AP> {
+    explicit policy_strategy(int factor) : factor(factor) {}
+    int value() const override { return factor; }
+    int factor;
+};
+
+template <typename PT, typename AP>
+struct throwing_policy_strategy : public strategy_base<PT, AP> {
+    throwing_policy_strategy() { throw std::runtime_error("Not today"); }
+    int value() const override { return 0; }
+};
+
+template <typename PT, typename AP>
+bool check_policy() {
+    using base_type = strategy_base<PT, AP>;
+    int const live = strategy::live;
+    {
+        ptr_type_t<base_type> first = ctr<base_type, policy_strategy<PT, AP>>(3);
+        ptr_type_t<base_type> second = ctr<base_type, policy_strategy<PT, AP>>(4);
+        YADI_ASSERT_EQ(7, first->value() + second->value());
+        YADI_ASSERT_EQ(live + 2, strategy::live);
+    }
+    YADI_ASSERT_EQ(live, strategy::live);
+
+    try {
+        ctr<base_type, throwing_policy_strategy<PT, AP>>();
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+    YADI_ASSERT_EQ(live, strategy::live);
+    return true;
+}
+
+YADI_TEST(pool_allocation_test) {
+    using pooled_base = strategy_base<pooled_ptr<strategy>, pool_allocation>;
+    using pooled_impl = policy_strategy<pooled_ptr<strategy>, pool_allocation>;
+    YADI_ASSERT_EQ(true, (check_policy<pooled_ptr<strategy>, pool_allocation>()));
+    YADI_ASSERT_EQ(true, (check_policy<std::shared_ptr<strategy>, pool_allocation>()));
+
+    // Freed blocks are reused
+    void* const address = ctr<pooled_base, pooled_impl>(1).get();
+    YADI_ASSERT_EQ(address, static_cast<void*>(ctr<pooled_base, pooled_impl>(2).get()));
+
+    // Released on another thread
+    std::vector<ptr_type_t<pooled_base>> created;
+    for (int i = 0; i < 100; ++i) {
+        created.push_back(ctr<pooled_base, pooled_impl>(i));
+    }
+    std::thread([&created]() { created.clear(); }).join();
+    YADI_ASSERT_EQ(0u, created.size());
+
+    // A thread that only frees gives the block back when it exits, for the next thread to take
+    void* const block = details::slab_pool<1008>::allocate();
+    std::thread([block]() { details::slab_pool<1008>::deallocate(block); }).join();
+    void* reused = nullptr;
+    std::thread([&reused]() {
+        reused = details::slab_pool<1008>::allocate();
+        details::slab_pool<1008>::deallocate(reused);
+    }).join();
+    YADI_ASSERT_EQ(block, reused);
+
+    // A default deleter owns objects made with new
+    pooled_ptr<strategy> adopted(new fixed_strategy<5>());
+    YADI_ASSERT_EQ(5, adopted->value());
+
+    return true;
+}
+
+YADI_TEST(arena_allocation_test) {
+    using arena_base = strategy_base<pooled_ptr<strategy>, arena_allocation>;
+    using arena_impl = policy_strategy<pooled_ptr<strategy>, arena_allocation>;
+    YADI_ASSERT_EQ(true, (check_policy<pooled_ptr<strategy>, arena_allocation>()));
+
+    arena request;
+    {
+        arena_scope scope(request);
+        YADI_ASSERT_EQ(&request, arena::current());
+        YADI_ASSERT_EQ(true, (check_policy<pooled_ptr<strategy>, arena_allocation>()));
+        YADI_ASSERT_EQ(true, (check_policy<std::shared_ptr<strategy>, arena_allocation>()));
+
+        // Consecutive objects are adjacent
+        ptr_type_t<arena_base> first = ctr<arena_base, arena_impl>(1);
+        ptr_type_t<arena_base> second = ctr<arena_base, arena_impl>(2);
+        YADI_ASSERT_EQ(reinterpret_cast<char*>(first.get()) + sizeof(arena_impl),
+                       reinterpret_cast<char*>(second.get()));
+
+        arena nested;
+        {
+            arena_scope inner(nested);
+            YADI_ASSERT_EQ(&nested, arena::current());
+        }
+        YADI_ASSERT_EQ(&request, arena::current());
+    }
+    YADI_ASSERT_EQ(nullptr, arena::current());
+    request.release();
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
@@ -0,0 +1,147 @@
+#include "test.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace yadi {
+
+// By value with a registration_mod, so scalars of it are always created through its factory
+template <>
+struct factory_traits<long long> {
+    using ptr_type = long long;
+    static constexpr bool direct_from_yaml = true;
+};
+
+template <>
+struct registration_mod<long long> {
+    static yadi_info_t<long long> mod(yadi_info_t<long long> yadis) {
+        initializer_type_t<long long> initializer = std::move(yadis.initializer);
+        yadis.initializer = [initializer](YAML::Node const& config) { return 2 * initializer(config); };
+        yadis.config_initializer = nullptr;
+        return yadis;
+    }
+};
+
+template <>
+struct factory_traits<unsigned long long> {
+    using ptr_type = unsigned long long;
+    static constexpr bool direct_from_yaml = true;
+};
+
+// Read as a character by yaml-cpp, never as a number
+template <>
+struct factory_traits<char> {
+    using ptr_type = char;
+    static constexpr bool direct_from_yaml = true;
+};
+
+YADI_INIT_BEGIN
+::yadi::register_type_lazy<char>(::yadi::type_by_value_key(), &::yadi::make_yaml_as_initializer_with_help<char>);
+::yadi::register_type_lazy<long long>(::yadi::type_by_value_key(),
+                                      &::yadi::make_yaml_as_initializer_with_help<long long>);
+::yadi::register_type_lazy<unsigned long long>(::yadi::type_by_value_key(),
+                                               &::yadi::make_yaml_as_initializer_with_help<unsigned long long>);
+YADI_INIT_END
+
+namespace {
+
+YADI_TEST(scalar_parse_test) {
+    int i = 0;
+    YADI_ASSERT_EQ(true, details::parse_scalar("-42", i));
+    YADI_ASSERT_EQ(-42, i);
+    YADI_ASSERT_EQ(true, details::parse_scalar("0", i));
+    YADI_ASSERT_EQ(0, i);
+    // Left to yaml-cpp
+    for (char const* scalar : {"010", "-010", "0x10", "+1", "1.5", "", "99999999999"}) {
+        YADI_ASSERT_EQ(false, details::parse_scalar(scalar, i));
+    }
+
+    double d = 0;
+    YADI_ASSERT_EQ(true, details::parse_scalar("-1.25e2", d));
+    YADI_ASSERT_EQ(-125.0, d);
+    YADI_ASSERT_EQ(false, details::parse_scalar(".inf", d));
+    YADI_ASSERT_EQ(false, details::parse_scalar("nan", d));
+
+    bool b = false;
+    YADI_ASSERT_EQ(true, details::parse_scalar("true", b));
+    YADI_ASSERT_EQ(true, b);
+    YADI_ASSERT_EQ(false, details::parse_scalar("yes", b));
+
+    char c = 0;
+    YADI_ASSERT_EQ(false, details::is_parsed_scalar<char>::value);
+    YADI_ASSERT_EQ(true, details::is_parsed_scalar<signed char>::value);
+    YADI_ASSERT_EQ(false, details::parse_scalar("7", c));
+
+    return true;
+}
+
+YADI_TEST(scalar_from_yaml_test) {
+    YADI_ASSERT_EQ(42, from_yaml<int>(YAML::Load("42")));
+    YADI_ASSERT_EQ(-7, from_yaml<int>(YAML::Load("-7")));
+    // Converted the way yaml-cpp does
+    YADI_ASSERT_EQ(31, from_yaml<int>(YAML::Load("0x1F")));
+    YADI_ASSERT_EQ(8, from_yaml<int>(YAML::Load("010")));
+    YADI_ASSERT_EQ(5, from_yaml<int>(YAML::Load("+5")));
+    YADI_ASSERT_EQ(8, from_yaml<int>(config_document::load("010").root()));
+    YADI_ASSERT_EQ(std::uint8_t(200), from_yaml<std::uint8_t>(YAML::Load("200")));
+
+    YADI_ASSERT_EQ(2.5, from_yaml<double>(YAML::Load("2.5")));
+    YADI_ASSERT_EQ(std::numeric_limits<double>::infinity(), from_yaml<double>(YAML::Load(".inf")));
+    YADI_ASSERT_EQ(2.5f, from_yaml<float>(config_document::load("2.5").root()));
+
+    YADI_ASSERT_EQ(true, from_yaml<bool>(YAML::Load("true")));
+    YADI_ASSERT_EQ(true, from_yaml<bool>(YAML::Load("yes")));
+    YADI_ASSERT_EQ(false, from_yaml<bool>(YAML::Load("False")));
+
+    YADI_ASSERT_EQ(std::string("a b"), from_yaml<std::string>(YAML::Load("a b")));
+    YADI_ASSERT_EQ(std::string("010"), from_yaml<std::string>(YAML::Load("010")));
+    YADI_ASSERT_EQ(std::string("c"), from_yaml<std::string>(config_document::load("c").root()));
+
+    YADI_ASSERT_EQ(YAML::Load("7").as<char>(), from_yaml<char>(YAML::Load("7")));
+    YADI_ASSERT_EQ('7', from_yaml<char>(YAML::Load("7")));
+    YADI_ASSERT_EQ('7', from_yaml<char>(config_document::load("7").root()));
+    YADI_ASSERT_EQ('7', try_from_yaml<char>(YAML::Load("7")).value());
+    YADI_ASSERT_EQ(YAML::Load("[7, A]").as<std::vector<char>>(), from_yaml<std::vector<char>>(YAML::Load("[7, A]")));
+
+    for (char const* config : {"x", "1.5", "99999999999"}) {
+        try {
+            from_yaml<int>(YAML::Load(config));
+            return false;
+        } catch (std::runtime_error const&) {
+        }
+        YADI_ASSERT_EQ(false, try_from_yaml<int>(config_document::load(config).root()).has_value());
+    }
+
+    return true;
+}
+
+YADI_TEST(scalar_registration_mod_test) {
+    YADI_ASSERT_EQ(42ll, from_yaml<long long>(YAML::Load("21")));
+    YADI_ASSERT_EQ(42ll, from_yaml<long long>(config_document::load("21").root()));
+
+    return true;
+}
+
+YADI_TEST(scalar_reregistered_test) {
+    YADI_ASSERT_EQ(5ull, from_yaml<unsigned long long>(YAML::Load("5")));
+
+    // Replacing the initializer is seen by the next conversion, restoring it brings the parse back
+    auto const plus_one = [](YAML::Node const& config) { return config.as<unsigned long long>() + 1; };
+    ::yadi::register_type<unsigned long long>(type_by_value_key(), plus_one);
+    YADI_ASSERT_EQ(6ull, from_yaml<unsigned long long>(YAML::Load("5")));
+    YADI_ASSERT_EQ(6ull, from_yaml<unsigned long long>(config_document::load("5").root()));
+
+    ::yadi::register_type_lazy<unsigned long long>(type_by_value_key(),
+                                                   &make_yaml_as_initializer_with_help<unsigned long long>);
+    YADI_ASSERT_EQ(5ull, from_yaml<unsigned long long>(YAML::Load("5")));
+    YADI_ASSERT_EQ(5ull, from_yaml<unsigned long long>(config_document::load("5").root()));
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
@@ -0,0 +1,158 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct static_shape {
+    virtual ~static_shape() = default;
+    virtual double area() const = 0;
+};
+
+struct static_rect : public static_shape {
+    explicit static_rect(YAML::Node const& config)
+        : width(config["width"].as<double>()), height(config["height"].as<double>()) {}
+    double area() const override { return width * height; }
+    double width;
+    double height;
+};
+
+struct static_point : public static_shape {
+    double area() const override { return 0; }
+};
+
+struct static_square : public static_shape {
+    explicit static_square(double side) : side(side) {}
+    double area() const override { return side * side; }
+    double side;
+};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<static_shape> {
+    using ptr_type = std::shared_ptr<static_shape>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+constexpr char RECT[] = "rect";
+constexpr char POINT[] = "point";
+constexpr char SQUARE[] = "square";
+
+ptr_type_t<static_shape> make_square(YAML::Node const& config) {
+    return ctr<static_shape, static_square>(config.as<double>());
+}
+
+using shape_registry =
+    static_registry<static_shape, static_type<RECT, &init_yaml<static_shape, static_rect>>,
+                    static_type<POINT, &init_no_arg<static_shape, static_point>>, static_type<SQUARE, &make_square>>;
+
+// Looked up at compile time
+static_assert(shape_registry::sorted_names[0].name == "point");
+static_assert(shape_registry::sorted_names[2].name == "square");
+static_assert(shape_registry::index_of("rect") == 0);
+static_assert(shape_registry::index_of("square") == 2);
+static_assert(!shape_registry::contains("circle"));
+static_assert(!static_registry<static_shape>::contains("rect"));
+
+}  // anonymous namespace
+
+template <>
+struct adapter<static_shape> : public static_adapter<shape_registry> {};
+
+namespace {
+
+YADI_INIT_BEGIN
+::yadi::register_type_no_arg<static_shape, static_point>("runtime_point");
+::yadi::register_alias<static_shape>("unit", "square", YAML::Load("1"));
+YADI_INIT_END
+
+YADI_TEST(static_registry_test) {
+    YADI_ASSERT_EQ(6.0, shape_registry::create("rect", YAML::Load("{width: 2, height: 3}"))->area());
+    YADI_ASSERT_EQ(0.0, shape_registry::create("point")->area());
+    YADI_ASSERT_EQ(9.0, shape_registry::create_at<2>(YAML::Load("3"))->area());
+
+    // Runtime registrations and aliases work alongside
+    YADI_ASSERT_EQ(0.0, shape_registry::create("runtime_point")->area());
+    YADI_ASSERT_EQ(1.0, shape_registry::create("unit")->area());
+
+    // from_yaml goes through the registry
+    std::vector<ptr_type_t<static_shape>> shapes;
+    from_yamls<ptr_type_t<static_shape>>(YAML::Load("[point, {type: square, config: 2}, runtime_point]"),
+                                         std::back_inserter(shapes));
+    YADI_ASSERT_EQ(3u, shapes.size());
+    YADI_ASSERT_EQ(4.0, shapes[1]->area());
+    config_document const document = config_document::load("{type: rect, config: {width: 1, height: 5}}");
+    YADI_ASSERT_EQ(5.0, from_yaml<ptr_type_t<static_shape>>(document.root())->area());
+
+    // Errors read the same as the runtime factory's
+    std::string static_error;
+    std::string runtime_error;
+    try {
+        shape_registry::create("circle");
+    } catch (std::exception const& ex) {
+        static_error = ex.what();
+    }
+    try {
+        factory<static_shape>::create("circle");
+    } catch (std::exception const& ex) {
+        runtime_error = ex.what();
+    }
+    YADI_ASSERT_NE(std::string(), static_error);
+    YADI_ASSERT_EQ(runtime_error, static_error);
+    try {
+        shape_registry::create("square", YAML::Load("[1]"));
+        return false;
+    } catch (std::runtime_error const& ex) {
+        YADI_ASSERT_EQ(0u, std::string(ex.what()).find("Error creating \"square\": "));
+    }
+
+    return true;
+}
+
+YADI_TEST(static_registry_register_types_test) {
+    YADI_ASSERT_EQ(nullptr, factory<static_shape>::find("rect"));
+    shape_registry::register_types("Static shape");
+    YADI_ASSERT_NE(nullptr, factory<static_shape>::find("rect"));
+    YADI_ASSERT_EQ(std::string("Static shape"), factory<static_shape>::find("square")->help);
+    YADI_ASSERT_EQ(4.0, factory<static_shape>::create("square", YAML::Load("2"))->area());
+
+    return true;
+}
+
+YADI_TEST(static_registry_trace_test) {
+    // Static types are traced like the factory's types
+    chrome_trace_sink sink;
+    set_trace_sink(&sink);
+    shape_registry::create("point");
+    shape_registry::create_at<2>(YAML::Load("3"));
+    set_trace_sink(nullptr);
+
+    std::vector<trace_record> const records = sink.records();
+    YADI_ASSERT_EQ(4u, records.size());
+    YADI_ASSERT_EQ(true, (records[0].kind == trace_kind::create && records[0].phase == trace_phase::begin));
+    YADI_ASSERT_EQ(std::string("point"), records[0].type);
+    YADI_ASSERT_EQ(true, (records[3].kind == trace_kind::create && records[3].phase == trace_phase::end));
+    YADI_ASSERT_EQ(std::string("square"), records[3].type);
+    YADI_ASSERT_EQ(demangle_type<static_shape>(), records[3].factory);
+
+#ifdef YADI_INSTRUMENT
+    reset_create_metrics();
+    shape_registry::create("point");
+    std::vector<create_metrics> const snapshot = create_metrics_snapshot();
+    YADI_ASSERT_EQ(true, std::any_of(snapshot.begin(), snapshot.end(), [](create_metrics const& metrics) {
+                       return metrics.factory == demangle_type<static_shape>() && metrics.type == "point" &&
+                              metrics.creates == 1;
+                   }));
+#endif  // YADI_INSTRUMENT
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
@@ -0,0 +1,174 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct traced {
+    virtual ~traced() = default;
+};
+
+struct traced_inner : public traced {
+    explicit traced_inner(YAML::Node const&) {}
+};
+
+struct traced_outer : public traced {
+    explicit traced_outer(YAML::Node const& config) : part(from_yaml<ptr_type_t<traced>>(config["part"])) {}
+
+    ptr_type_t<traced> part;
+};
+
+YADI_INIT_BEGIN
+::yadi::register_type<traced, traced_inner>("inner");
+::yadi::register_type<traced, traced_outer>("outer");
+YADI_INIT_END
+
+void build_outer() {
+    YAML::Node const config = YAML::Load("type: outer\nconfig:\n  part: inner\n");
+    from_yaml<ptr_type_t<traced>>(config);
+}
+
+/**
+ * @brief Phase, kind and type of each record, as "B from_yaml outer".
+ */
+std::vector<std::string> spans(std::vector<trace_record> const& records) {
+    std::vector<std::string> out;
+    for (trace_record const& record : records) {
+        char const* kind = record.kind == trace_kind::create ? "create" : "from_yaml";
+        out.push_back(std::string(record.phase == trace_phase::begin ? "B " : "E ") + kind + " " + record.type);
+    }
+    return out;
+}
+
+YADI_TEST(trace_nested_spans_test) {
+    build_outer();
+
+    chrome_trace_sink sink;
+    set_trace_sink(&sink);
+    YADI_ASSERT_EQ(&sink, get_trace_sink());
+    build_outer();
+    set_trace_sink(nullptr);
+    // Not traced
+    build_outer();
+
+    std::vector<trace_record> const records = sink.records();
+    std::vector<std::string> const expected{"B from_yaml outer", "B create outer", "B from_yaml inner",
+                                            "B create inner",    "E create inner", "E from_yaml inner",
+                                            "E create outer",    "E from_yaml outer"};
+    YADI_ASSERT_EQ(expected, spans(records));
+
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        YADI_ASSERT_EQ(true, (records[i - 1].timestamp <= records[i].timestamp));
+        YADI_ASSERT_EQ(records[0].thread, records[i].thread);
+    }
+    YADI_ASSERT_EQ(demangle_type<traced>(), records[0].factory);
+    // The outer config is the whole document, the inner is the scalar under part
+    YADI_ASSERT_EQ(0, records[0].line);
+    YADI_ASSERT_EQ(0, records[0].column);
+    YADI_ASSERT_EQ(2, records[2].line);
+    YADI_ASSERT_EQ(8, records[2].column);
+    YADI_ASSERT_EQ(-1, records[1].line);
+
+    return true;
+}
+
+YADI_TEST(trace_ring_test) {
+    trace_ring_sink sink(3);
+    set_trace_sink(&sink);
+    build_outer();
+    set_trace_sink(nullptr);
+
+    // Rounded up to 4, keeping the last 4 events
+    std::vector<std::string> const expected{"E create inner", "E from_yaml inner", "E create outer",
+                                            "E from_yaml outer"};
+    std::vector<trace_record> const records = sink.records();
+    YADI_ASSERT_EQ(expected, spans(records));
+    YADI_ASSERT_EQ(demangle_type<traced>(), records[0].factory);
+    YADI_ASSERT_EQ(2, records[1].line);
+    YADI_ASSERT_EQ(8, records[1].column);
+
+    return true;
+}
+
+YADI_TEST(trace_ring_names_test) {
+    // Names are kept by the sink rather than interned for the life of the process
+    trace_ring_sink sink(8);
+    std::string const name = "traced_name_not_registered";
+    sink.record(trace_event{trace_phase::begin, trace_kind::create, "factory", name, -1, -1, 0, 1});
+    YADI_ASSERT_EQ(false, type_id::find(name).valid());
+    YADI_ASSERT_EQ(name, sink.records().back().type);
+
+    // The table is bounded, names beyond it are recorded as ...
+    for (int i = 0; i < 8192; ++i) {
+        sink.record(trace_event{trace_phase::end, trace_kind::create, "factory", std::to_string(i), -1, -1, 0, 1});
+    }
+    YADI_ASSERT_EQ(std::string("..."), sink.records().back().type);
+    YADI_ASSERT_EQ(std::string("factory"), sink.records().back().factory);
+
+    return true;
+}
+
+YADI_TEST(trace_alias_test) {
+    register_alias<traced>("inner_alias", "inner");
+    register_alias<traced>("inner_alias_chain", "inner_alias");
+    factory<traced>::create("inner_alias_chain");
+
+    chrome_trace_sink sink;
+    set_trace_sink(&sink);
+    factory<traced>::create("inner_alias_chain");
+    set_trace_sink(nullptr);
+
+    // The chain is flattened, so the terminal is created directly under the alias
+    std::vector<std::string> const expected{"B create inner_alias_chain", "B create inner", "E create inner",
+                                            "E create inner_alias_chain"};
+    YADI_ASSERT_EQ(expected, spans(sink.records()));
+
+    return true;
+}
+
+YADI_TEST(trace_scalar_test) {
+    chrome_trace_sink sink;
+    set_trace_sink(&sink);
+    from_yaml<int>(YAML::Load("5"));
+    from_yaml<std::vector<int>>(YAML::Load("[1, 2]"));
+    set_trace_sink(nullptr);
+
+    // Scalars by value, alone or in a sequence, aren't parsed past the factory while traced
+    std::vector<std::string> const recorded = spans(sink.records());
+    YADI_ASSERT_EQ(3, std::count(recorded.begin(), recorded.end(), "B create " + type_by_value_key()));
+
+    return true;
+}
+
+YADI_TEST(trace_chrome_format_test) {
+    std::vector<trace_record> const records{
+        {trace_phase::begin, trace_kind::from_yaml, "shape", "rect \"big\"", 3, 4, 1500, 1},
+        {trace_phase::begin, trace_kind::create, "shape", "rect", -1, -1, 2000, 1},
+        {trace_phase::end, trace_kind::create, "shape", "rect", -1, -1, 2250, 1},
+        {trace_phase::end, trace_kind::from_yaml, "shape", "rect \"big\"", 3, 4, 3000, 1}};
+
+    std::ostringstream out;
+    write_chrome_trace(out, records);
+    YADI_ASSERT_EQ(std::string("{\"traceEvents\": [\n"
+                               "  {\"ph\": \"B\", \"ts\": 1.500, \"pid\": 1, \"tid\": 1, "
+                               "\"name\": \"rect \\\"big\\\"\", \"cat\": \"from_yaml\", "
+                               "\"args\": {\"factory\": \"shape\", \"line\": 3, \"column\": 4}},\n"
+                               "  {\"ph\": \"B\", \"ts\": 2.000, \"pid\": 1, \"tid\": 1, \"name\": \"rect\", "
+                               "\"cat\": \"create\", \"args\": {\"factory\": \"shape\"}},\n"
+                               "  {\"ph\": \"E\", \"ts\": 2.250, \"pid\": 1, \"tid\": 1},\n"
+                               "  {\"ph\": \"E\", \"ts\": 3.000, \"pid\": 1, \"tid\": 1}\n"
+                               "]}\n"),
+                   out.str());
+
+    // The same escaping as the inspector's JSON output
+    YADI_ASSERT_EQ(std::string("\"a\\\\b\\u000a\""), details::json_string("a\\b\n"));
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
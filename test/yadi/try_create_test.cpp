@@ -0,0 +1,144 @@
+#include "test.hpp"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct probe {
+    virtual ~probe() = default;
+    virtual int level() const = 0;
+};
+
+struct fixed_probe : public probe {
+    explicit fixed_probe(YAML::Node const& config) : value(config.IsScalar() ? config.as<int>() : 0) {}
+    int level() const override { return value; }
+    int value;
+};
+
+ptr_type_t<probe> make_failing_probe(YAML::Node const&) { throw std::invalid_argument("probe offline"); }
+
+YADI_INIT_BEGIN
+::yadi::register_type<probe, fixed_probe>("fixed");
+::yadi::register_type<probe>("failing", {&make_failing_probe, "Always fails"});
+YADI_INIT_END
+
+std::string thrown_message(std::function<void()> const& func) {
+    try {
+        func();
+    } catch (std::exception const& ex) {
+        return ex.what();
+    }
+    return "";
+}
+
+YADI_TEST(try_create_test) {
+    create_result<ptr_type_t<probe>> created = factory<probe>::try_create("fixed", YAML::Load("3"));
+    YADI_ASSERT_EQ(true, created.has_value());
+    YADI_ASSERT_EQ(3, created.value()->level());
+    YADI_ASSERT_EQ(3, (*created)->level());
+
+    create_result<ptr_type_t<probe>> missing = factory<probe>::try_create("missing");
+    YADI_ASSERT_EQ(false, static_cast<bool>(missing));
+    YADI_ASSERT_EQ(error_code::type_not_found, missing.error().code());
+    YADI_ASSERT_EQ(std::string("missing"), missing.error().type());
+    // Same message the throwing API reports
+    std::string const not_found = thrown_message([] { factory<probe>::create("missing"); });
+    YADI_ASSERT_EQ(not_found, missing.error().message());
+    YADI_ASSERT_EQ(not_found, thrown_message([&missing] { missing.value(); }));
+
+    create_result<ptr_type_t<probe>> failed = factory<probe>::try_create(factory<probe>::resolve("failing"));
+    YADI_ASSERT_EQ(error_code::initializer_failed, failed.error().code());
+    YADI_ASSERT_EQ(std::string("Error creating \"failing\": probe offline"), failed.error().message());
+    try {
+        std::rethrow_exception(failed.error().cause());
+    } catch (std::invalid_argument const& ex) {
+        YADI_ASSERT_EQ(std::string("probe offline"), std::string(ex.what()));
+    }
+
+    int const level = std::move(factory<probe>::try_create("missing")).value_or(nullptr) ? 1 : 0;
+    YADI_ASSERT_EQ(0, level);
+
+    return true;
+}
+
+YADI_TEST(try_from_yaml_test) {
+    YADI_ASSERT_EQ(5, try_from_yaml<ptr_type_t<probe>>(YAML::Load("{type: fixed, config: 5}")).value()->level());
+
+    auto const error_of = [](std::string const& yaml) {
+        return try_from_yaml<ptr_type_t<probe>>(YAML::Load(yaml)).error();
+    };
+    YAML::Node const empty = YAML::Load("{}");
+    YADI_ASSERT_EQ(error_code::config_not_defined, try_from_yaml<ptr_type_t<probe>>(empty["probe"]).error().code());
+    YADI_ASSERT_EQ(error_code::scalar_not_valid, error_of("''").code());
+    YADI_ASSERT_EQ(error_code::type_not_defined, error_of("{config: 1}").code());
+    YADI_ASSERT_EQ(error_code::type_not_valid, error_of("{type: [a]}").code());
+    YADI_ASSERT_EQ(std::string("type"), error_of("{type: [a]}").path());
+    YADI_ASSERT_EQ(error_code::config_not_valid, error_of("[a]").code());
+
+    create_error const unknown = error_of("{type: missing}");
+    YADI_ASSERT_EQ(error_code::type_not_found, unknown.code());
+    YADI_ASSERT_EQ(std::string("type"), unknown.path());
+    create_error const failed = error_of("{type: failing, config: 1}");
+    YADI_ASSERT_EQ(error_code::initializer_failed, failed.code());
+    YADI_ASSERT_EQ(std::string("config"), failed.path());
+
+    // The throwing API reports the same messages
+    YADI_ASSERT_EQ(std::string("Factory config type not defined"),
+                   thrown_message([] { from_yaml<ptr_type_t<probe>>(YAML::Load("{config: 1}")); }));
+    YADI_ASSERT_EQ(error_of("scalar_missing").message(),
+                   thrown_message([] { from_yaml<ptr_type_t<probe>>(YAML::Load("scalar_missing")); }));
+
+    // Read from a config_document
+    config_document const document = config_document::load("[fixed, {type: missing}]");
+    YADI_ASSERT_EQ(0, try_from_yaml<ptr_type_t<probe>>(document.root()[0]).value()->level());
+    YADI_ASSERT_EQ(error_code::type_not_found, try_from_yaml<ptr_type_t<probe>>(document.root()[1]).error().code());
+
+    return true;
+}
+
+YADI_TEST(try_from_yamls_test) {
+    std::vector<ptr_type_t<probe>> probes;
+    create_result<std::size_t> const count =
+        try_from_yamls<ptr_type_t<probe>>(YAML::Load("[fixed, {type: fixed, config: 2}]"), std::back_inserter(probes));
+    YADI_ASSERT_EQ(2u, count.value());
+    YADI_ASSERT_EQ(2, probes[1]->level());
+
+    // Elements before the failure are written
+    probes.clear();
+    create_result<std::size_t> const failed = try_from_yamls<ptr_type_t<probe>>(
+        YAML::Load("[fixed, {type: missing}, fixed]"), std::back_inserter(probes));
+    YADI_ASSERT_EQ(error_code::type_not_found, failed.error().code());
+    YADI_ASSERT_EQ(std::string("[1].type"), failed.error().path());
+    YADI_ASSERT_EQ(1u, probes.size());
+
+    config_document const document = config_document::load("[fixed, {type: failing}]");
+    probes.clear();
+    create_result<std::size_t> const document_failed =
+        try_from_yamls<ptr_type_t<probe>>(document.root(), std::back_inserter(probes));
+    YADI_ASSERT_EQ(std::string("[1].config"), document_failed.error().path());
+    YAML::Node const empty = YAML::Load("{}");
+    YADI_ASSERT_EQ(error_code::configs_not_defined,
+                   try_from_yamls<ptr_type_t<probe>>(empty["probes"], std::back_inserter(probes)).error().code());
+
+    return true;
+}
+
+YADI_TEST(try_from_yaml_adapter_test) {
+    using probe_map = std::map<std::string, int>;
+    YADI_ASSERT_EQ(2, try_from_yaml<probe_map>(YAML::Load("{a: 1, b: 2}")).value().at("b"));
+
+    // Adapters without try_create are called through create, what they throw is kept
+    create_result<probe_map> const failed = try_from_yaml<probe_map>(YAML::Load("[1, 2]"));
+    YADI_ASSERT_EQ(error_code::adapter_failed, failed.error().code());
+    YADI_ASSERT_EQ(std::string("Must create map from map"), failed.error().message());
+    YADI_ASSERT_EQ(failed.error().message(), thrown_message([] { from_yaml<probe_map>(YAML::Load("[1, 2]")); }));
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
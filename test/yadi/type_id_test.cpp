@@ -0,0 +1,74 @@
+#include "test.hpp"
+
+namespace yadi {
+namespace {
+
+struct identified {
+    int value;
+};
+
+struct other_identified {};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<identified> {
+    using ptr_type = identified;
+    static constexpr bool direct_from_yaml = false;
+};
+
+template <>
+struct factory_traits<other_identified> {
+    using ptr_type = other_identified;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+YADI_TEST(type_id_test) {
+    ::yadi::register_type<identified>("identified_one", [](YAML::Node const& config) {
+        return identified{config.as<int>(1)};
+    });
+    ::yadi::register_type<identified>("identified_two", [](YAML::Node const&) { return identified{2}; });
+
+    type_id const one = factory<identified>::resolve("identified_one");
+    type_id const two = factory<identified>::resolve("identified_two");
+    YADI_ASSERT_EQ(true, one.valid());
+    YADI_ASSERT_NE(one, two);
+    YADI_ASSERT_EQ(std::string_view("identified_one"), one.name());
+    YADI_ASSERT_EQ(one, type_id::find("identified_one"));
+    YADI_ASSERT_EQ(1, factory<identified>::create(one).value);
+    YADI_ASSERT_EQ(5, factory<identified>::create(one, YAML::Load("5")).value);
+    YADI_ASSERT_EQ(2, factory<identified>::create(two).value);
+
+    // Re-registering keeps the ID
+    ::yadi::register_type<identified>("identified_one", [](YAML::Node const&) { return identified{11}; });
+    YADI_ASSERT_EQ(one, factory<identified>::resolve("identified_one"));
+    YADI_ASSERT_EQ(11, factory<identified>::create(one).value);
+
+    // IDs are shared across factories, but registration isn't
+    ::yadi::register_type<other_identified>("identified_two", [](YAML::Node const&) { return other_identified{}; });
+    YADI_ASSERT_EQ(two, factory<other_identified>::resolve("identified_two"));
+    try {
+        factory<other_identified>::create(one);
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    try {
+        factory<identified>::resolve("identified_missing");
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+    YADI_ASSERT_EQ(false, type_id::find("identified_missing").valid());
+    try {
+        factory<identified>::create(type_id());
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
@@ -79,4 +79,62 @@ a4: 4.5
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+double optional_sum(double a1, std::optional<int> a2) { return a1 + a2.value_or(100); }
+
+YADI_TEST(yaml_bindings_map_plan_test) {
+    auto strict = ::yadi::make_map_initializer<double>(&optional_sum, {"a1", "a2"}, true);
+    auto lenient = ::yadi::make_map_initializer<double>(&optional_sum, {"a1", "a2"}, false);
+
+    // Missing optional field
+    YADI_ASSERT_EQ(101.5, strict(YAML::Load("{a1: 1.5}")));
+    YADI_ASSERT_EQ(101.5, strict(YAML::Load("{a1: 1.5, a2: ~}")));
+    YADI_ASSERT_EQ(3.5, strict(YAML::Load("{a2: 2, a1: 1.5}")));
+
+    // Unknown fields are only an error when strict
+    YADI_ASSERT_EQ(3.5, lenient(YAML::Load("{a1: 1.5, a2: 2, a3: 3}")));
+    try {
+        strict(YAML::Load("{a1: 1.5, a2: 2, a3: 3}"));
+        return false;
+    } catch (std::runtime_error const& ex) {
+        YADI_ASSERT_NE(std::string::npos, std::string(ex.what()).find("\"a3\""));
+    }
+
+    // Conversion errors name the field
+    try {
+        strict(YAML::Load("{a1: 1.5, a2: [1]}"));
+        return false;
+    } catch (std::exception const& ex) {
+        YADI_ASSERT_NE(std::string::npos, std::string(ex.what()).find("a2"));
+    }
+
+    // Not a map
+    try {
+        strict(YAML::Load("[1.5, 2]"));
+        return false;
+    } catch (std::runtime_error const&) {
+    }
+
+    return true;
+}
+
+YADI_TEST(yaml_bindings_map_repeated_field_test) {
+    try {
+        ::yadi::make_map_initializer<double>(&optional_sum, {"a1", "a1"});
+        return false;
+    } catch (std::runtime_error const& ex) {
+        std::string const what = ex.what();
+        YADI_ASSERT_NE(std::string::npos, what.find("\"a1\""));
+        YADI_ASSERT_NE(std::string::npos, what.find("double"));
+    }
+
+    try {
+        ::yadi::make_map_initializer_with_help<double>(&optional_sum, std::vector<std::string>{"a2", "a2"});
+        return false;
+    } catch (std::runtime_error const& ex) {
+        YADI_ASSERT_NE(std::string::npos, std::string(ex.what()).find("\"a2\""));
+    }
+
+    return true;
+}
@@ -0,0 +1,86 @@
+#include "test.hpp"
+
+namespace yadi {
+namespace {
+
+struct keyed_service {};
+
+}  // anonymous namespace
+
+template <>
+struct factory_traits<keyed_service> {
+    using ptr_type = std::shared_ptr<keyed_service>;
+    static constexpr bool direct_from_yaml = false;
+};
+
+namespace {
+
+YADI_TEST(yaml_hash_order_test) {
+    YAML::Node const left = YAML::Load("{a: 1, b: [1, 2, {c: 3, d: 4}], e: {f: g}}");
+    YAML::Node const right = YAML::Load("{e: {f: g}, b: [1, 2, {d: 4, c: 3}], a: 1}");
+    YADI_ASSERT_EQ(yaml_hash(left), yaml_hash(right));
+    YADI_ASSERT_EQ(true, yaml_equal(left, right));
+
+    // Sequences are ordered
+    YAML::Node const swapped = YAML::Load("{a: 1, b: [2, 1, {c: 3, d: 4}], e: {f: g}}");
+    YADI_ASSERT_EQ(false, yaml_equal(left, swapped));
+    YADI_ASSERT_NE(yaml_hash(left), yaml_hash(swapped));
+
+    YADI_ASSERT_EQ(false, yaml_equal(YAML::Load("{a: 1}"), YAML::Load("{a: 2}")));
+    YADI_ASSERT_EQ(false, yaml_equal(YAML::Load("{a: 1}"), YAML::Load("{b: 1}")));
+    YADI_ASSERT_EQ(false, yaml_equal(YAML::Load("[1]"), YAML::Load("1")));
+    YADI_ASSERT_EQ(true, yaml_equal(YAML::Load("'1'"), YAML::Load("1")));
+    YADI_ASSERT_EQ(false, yaml_equal(YAML::Load("!foo 1"), YAML::Load("1")));
+
+    return true;
+}
+
+YADI_TEST(yaml_hash_large_map_test) {
+    YAML::Node left;
+    YAML::Node right;
+    for (int i = 0; i < 100; ++i) {
+        left["key_" + std::to_string(i)] = i;
+        right["key_" + std::to_string(99 - i)] = 99 - i;
+    }
+    YADI_ASSERT_EQ(yaml_hash(left), yaml_hash(right));
+    YADI_ASSERT_EQ(true, yaml_equal(left, right));
+
+    right["key_50"] = -1;
+    YADI_ASSERT_EQ(false, yaml_equal(left, right));
+
+    return true;
+}
+
+YADI_TEST(yaml_hash_undefined_test) {
+    YAML::Node const map = YAML::Load("{a: 1}");
+    YAML::Node const missing = map["missing"];
+    YADI_ASSERT_EQ(true, yaml_equal(missing, map["other"]));
+    YADI_ASSERT_EQ(false, yaml_equal(missing, YAML::Node()));
+    YADI_ASSERT_EQ(yaml_hash(missing), yaml_hash(map["other"]));
+
+    return true;
+}
+
+YADI_TEST(caching_key_order_test) {
+    auto initializer = make_caching_initializer<keyed_service>(
+        [](YAML::Node const&) { return std::make_shared<keyed_service>(); });
+
+    YAML::Node config = YAML::Load("{a: 1, b: 2}");
+    std::shared_ptr<keyed_service> first = initializer(config);
+    YADI_ASSERT_EQ(first, initializer(YAML::Load("{b: 2, a: 1}")));
+    YADI_ASSERT_NE(first, initializer(YAML::Load("{b: 3, a: 1}")));
+
+    // Changing the config after the fact doesn't change the cached key
+    config["a"] = 5;
+    YADI_ASSERT_EQ(first, initializer(YAML::Load("{a: 1, b: 2}")));
+
+    // Missing config is consistently a hit
+    YAML::Node const missing = YAML::Load("{}")["config"];
+    std::shared_ptr<keyed_service> unconfigured = initializer(missing);
+    YADI_ASSERT_EQ(unconfigured, initializer(missing));
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi
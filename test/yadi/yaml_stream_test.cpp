@@ -0,0 +1,132 @@
+#include "test.hpp"
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace yadi {
+namespace {
+
+struct stream_rule {
+    stream_rule(std::string name, std::vector<int> ids) : name(std::move(name)), ids(std::move(ids)) {}
+    std::string name;
+    std::vector<int> ids;
+};
+
+ptr_type_t<stream_rule> make_stream_rule(std::string name, std::vector<int> ids) {
+    return ctr<stream_rule, stream_rule>(std::move(name), std::move(ids));
+}
+
+YADI_INIT_BEGIN
+::yadi::register_type<stream_rule>(
+    "rule", make_map_initializer<stream_rule>(&make_stream_rule, std::vector<std::string>{"name", "ids"}));
+YADI_INIT_END
+
+YADI_TEST(yaml_stream_test) {
+    std::istringstream input(R"raw(
+- {type: rule, config: {name: first, ids: [1, 2]}}
+- type: rule
+  config:
+    name: &shared second
+    ids: &ids [3]
+- {type: rule, config: {name: *shared, ids: *ids}}
+---
+{type: rule, config: {name: single, ids: []}}
+)raw");
+    std::vector<ptr_type_t<stream_rule>> rules;
+    std::size_t const count = from_yaml_stream<ptr_type_t<stream_rule>>(
+        input, [&rules](ptr_type_t<stream_rule> rule) { rules.push_back(std::move(rule)); });
+
+    YADI_ASSERT_EQ(4u, count);
+    YADI_ASSERT_EQ(4u, rules.size());
+    YADI_ASSERT_EQ(std::string("first"), rules[0]->name);
+    YADI_ASSERT_EQ((std::vector<int>{1, 2}), rules[0]->ids);
+    YADI_ASSERT_EQ(std::string("second"), rules[1]->name);
+    // Aliases reach anchors in earlier elements
+    YADI_ASSERT_EQ(std::string("second"), rules[2]->name);
+    YADI_ASSERT_EQ((std::vector<int>{3}), rules[2]->ids);
+    YADI_ASSERT_EQ(std::string("single"), rules[3]->name);
+
+    // Same elements as from_yamls
+    std::string const flow = "[{type: rule, config: {name: a, ids: [5]}}, {type: rule, config: {name: b, ids: []}}]";
+    std::vector<ptr_type_t<stream_rule>> loaded;
+    from_yamls<ptr_type_t<stream_rule>>(YAML::Load(flow), std::back_inserter(loaded));
+    std::vector<ptr_type_t<stream_rule>> streamed;
+    from_yaml_stream<ptr_type_t<stream_rule>>(
+        flow, [&streamed](ptr_type_t<stream_rule> rule) { streamed.push_back(std::move(rule)); });
+    YADI_ASSERT_EQ(loaded.size(), streamed.size());
+    for (std::size_t i = 0; i < loaded.size(); ++i) {
+        YADI_ASSERT_EQ(loaded[i]->name, streamed[i]->name);
+        YADI_ASSERT_EQ(loaded[i]->ids, streamed[i]->ids);
+    }
+
+    return true;
+}
+
+YADI_TEST(yaml_stream_mark_test) {
+    std::string const input = "- {type: rule}\n- type: rule\n  config:\n    name: a\n-\n  {type: rule}\n";
+
+    // Each element is visited with where it was parsed, as it is loaded whole
+    std::vector<std::pair<int, int>> loaded;
+    for (YAML::Node const& element : YAML::Load(input)) {
+        loaded.emplace_back(element.Mark().line, element.Mark().column);
+    }
+    std::vector<std::pair<int, int>> streamed;
+    std::istringstream stream(input);
+    details::for_each_yaml_element(stream, stream_format::yaml,
+                                   [&streamed](YAML::Node const&, std::size_t, YAML::Mark const& mark) {
+                                       streamed.emplace_back(mark.line, mark.column);
+                                   });
+    YADI_ASSERT_EQ(3u, streamed.size());
+    YADI_ASSERT_EQ(loaded, streamed);
+
+    return true;
+}
+
+YADI_TEST(yaml_stream_json_lines_test) {
+    std::string const input =
+        "{\"type\": \"rule\", \"config\": {\"name\": \"a\", \"ids\": [1]}}\n"
+        "\n"
+        "{\"type\": \"rule\", \"config\": {\"name\": \"b\", \"ids\": [2, 3]}}\n";
+    std::vector<std::string> names;
+    std::size_t const count = from_yaml_stream<ptr_type_t<stream_rule>>(
+        input, [&names](ptr_type_t<stream_rule> rule) { names.push_back(rule->name); }, stream_format::json_lines);
+    YADI_ASSERT_EQ(2u, count);
+    YADI_ASSERT_EQ((std::vector<std::string>{"a", "b"}), names);
+
+    return true;
+}
+
+YADI_TEST(yaml_stream_error_test) {
+    std::string const input = "- {type: rule, config: {name: a, ids: []}}\n- {type: missing}\n- {type: rule}\n";
+    std::size_t created = 0;
+    try {
+        from_yaml_stream<ptr_type_t<stream_rule>>(input, [&created](ptr_type_t<stream_rule>) { ++created; });
+        return false;
+    } catch (std::runtime_error const& ex) {
+        // Elements before the failure were already passed on
+        YADI_ASSERT_EQ(1u, created);
+        YADI_ASSERT_EQ(0u, std::string(ex.what()).find("Error creating element 1 at line 2: "));
+    }
+
+    // The top level sequence is never built, so it can't be aliased
+    try {
+        from_yaml_stream<ptr_type_t<stream_rule>>(
+            std::string_view("&top [{type: rule, config: {name: a, ids: []}}, *top]"), [](ptr_type_t<stream_rule>) {});
+        return false;
+    } catch (std::runtime_error const& ex) {
+        YADI_ASSERT_EQ(0u, std::string(ex.what()).find("Alias at line 1 refers to the top level sequence"));
+    }
+
+    try {
+        from_yaml_stream<ptr_type_t<stream_rule>>(std::string_view("- [unclosed"), [](ptr_type_t<stream_rule>) {});
+        return false;
+    } catch (YAML::ParserException const&) {
+    }
+
+    return true;
+}
+
+}  // anonymous namespace
+}  // namespace yadi